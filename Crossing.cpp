@@ -0,0 +1,178 @@
+#include "Crossing.h"
+#include <math.h>
+
+Real sunAltitude(void * sun, time_t t) {
+	return ((Sun *)sun)->altitudeAt(t);
+}
+
+Real moonAltitude(void * moon, time_t t) {
+	return ((Moon *)moon)->altitudeAt(t);
+}
+
+// Brent's method on [a, b], seconds after start, where fa and fb have opposite signs.
+// inverse quadratic or secant steps are taken while they shrink the bracket fast
+// enough, bisection otherwise.
+static time_t refine(AltitudeFunction altitude, void * body, Real threshold, time_t start,
+		double a, double b, Real fa, Real fb, uint32_t tolerance) {
+	double c = a, d = b - a, e = d;
+	Real fc = fa;
+	while (true) {
+		if ((fb > 0) == (fc > 0)) {
+			c = a;
+			fc = fa;
+			d = e = b - a;
+		}
+		if (fabs(fc) < fabs(fb)) {
+			a = b;
+			b = c;
+			c = a;
+			fa = fb;
+			fb = fc;
+			fc = fa;
+		}
+		double tol = tolerance > 1 ? (double)tolerance / 2 : 0.5;
+		double m = (c - b) / 2;
+		if (fabs(m) <= tol || fb == 0)
+			return start + (time_t)round(b);
+		if (fabs(e) >= tol && fabs(fa) > fabs(fb)) {
+			double s = (double)fb / fa, p, q;
+			if (a == c) {
+				p = 2 * m * s;
+				q = 1 - s;
+			} else {
+				double r = (double)fb / fc;
+				q = (double)fa / fc;
+				p = s * (2 * m * q * (q - r) - (b - a) * (r - 1));
+				q = (q - 1) * (r - 1) * (s - 1);
+			}
+			if (p > 0)
+				q = -q;
+			else
+				p = -p;
+			if (2 * p < 3 * m * q - fabs(tol * q) && 2 * p < fabs(e * q)) {
+				e = d;
+				d = p / q;
+			} else {
+				d = m;
+				e = m;
+			}
+		} else {
+			d = m;
+			e = m;
+		}
+		a = b;
+		fa = fb;
+		if (fabs(d) > tol)
+			b += d;
+		else
+			b += m > 0 ? tol : -tol;
+		fb = altitude(body, start + (time_t)round(b)) - threshold;
+	}
+}
+
+// the vertex of the parabola through three samples one step apart, at x = -1, 0, 1.
+// returns false unless it lies within [from, to] on the other side of the threshold
+// than the samples, in which case the altitude may dip across it between two samples.
+static bool dip(Real hp, Real h, Real hn, Real from, Real to, Real * x) {
+	Real a = (hp + hn) / 2 - h;
+	Real b = (hn - hp) / 2;
+	if (a == 0)
+		return false;
+	*x = -b / (2 * a);
+	Real y = h - b * b / (4 * a);
+	return *x > from && *x < to && (y < 0) != (h < 0);
+}
+
+typedef struct {
+	AltitudeFunction altitude;
+	void * body;
+	Real threshold;
+	time_t start;
+	uint32_t tolerance;
+	Real rate;
+	Crossing * crossings;
+	uint8_t max;
+	uint8_t count;
+} Search;
+
+// crossings between the samples at t0 and t1, splitting the interval in halves while
+// the altitude could dip across the threshold and back between samples on one side
+static void search(Search * s, uint32_t t0, Real h0, uint32_t t1, Real h1) {
+	if (s->count >= s->max)
+		return;
+	if ((h0 < 0) != (h1 < 0)) {
+		s->crossings[s->count].time = refine(s->altitude, s->body, s->threshold, s->start, t0, t1, h0, h1,
+				s->tolerance);
+		s->crossings[s->count].rising = h0 < 0;
+		s->count++;
+		return;
+	}
+	if (t1 - t0 <= 2 * s->tolerance || (t1 - t0) * s->rate <= fabs(h0) + fabs(h1))
+		return;
+	uint32_t tm = t0 + (t1 - t0) / 2;
+	Real hm = s->altitude(s->body, s->start + tm) - s->threshold;
+	search(s, t0, h0, tm, hm);
+	search(s, tm, hm, t1, h1);
+}
+
+uint8_t findCrossings(AltitudeFunction altitude, void * body, Real threshold,
+		time_t start, uint32_t span, uint32_t step, uint32_t tolerance,
+		Crossing * crossings, uint8_t max, Real rate) {
+	if (rate > 0) {
+		Search s = { altitude, body, threshold, start, tolerance, rate, crossings, max, 0 };
+		Real h0 = altitude(body, start) - threshold;
+		for (uint32_t t0 = 0; t0 < span && s.count < max; ) {
+			uint32_t t1 = t0 + step < span ? t0 + step : span;
+			Real h1 = altitude(body, start + t1) - threshold;
+			search(&s, t0, h0, t1, h1);
+			t0 = t1;
+			h0 = h1;
+		}
+		return s.count;
+	}
+	uint8_t count = 0;
+	uint32_t t0 = 0;
+	Real h0 = altitude(body, start) - threshold;
+	Real hp = 0, hn = 0;
+	bool haveNext = false;
+	while (t0 < span && count < max) {
+		uint32_t t1 = t0 + step < span ? t0 + step : span;
+		Real h1 = haveNext ? hn : altitude(body, start + t1) - threshold;
+		haveNext = false;
+		uint32_t tm = 0;
+		Real hm = 0, x;
+		if ((h0 < 0) == (h1 < 0) && t1 - t0 == step) {
+			// both ends on the same side: look for a short dip across the threshold
+			bool found = false;
+			if (t0 > 0) {
+				found = dip(hp, h0, h1, 0, 1, &x);
+			} else if (t1 + step <= span) {
+				hn = altitude(body, start + t1 + step) - threshold;
+				haveNext = true;
+				found = dip(h0, h1, hn, -1, 0, &x);
+				x += 1;
+			}
+			if (found) {
+				tm = t0 + (uint32_t)(x * step);
+				hm = altitude(body, start + tm) - threshold;
+			}
+		}
+		if (tm && (hm < 0) != (h0 < 0)) {
+			crossings[count].time = refine(altitude, body, threshold, start, t0, tm, h0, hm, tolerance);
+			crossings[count].rising = h0 < 0;
+			if (++count < max) {
+				crossings[count].time = refine(altitude, body, threshold, start, tm, t1, hm, h1, tolerance);
+				crossings[count].rising = hm < 0;
+				count++;
+			}
+		} else if ((h0 < 0) != (h1 < 0)) {
+			crossings[count].time = refine(altitude, body, threshold, start, t0, t1, h0, h1, tolerance);
+			crossings[count].rising = h0 < 0;
+			count++;
+		}
+		hp = h0;
+		t0 = t1;
+		h0 = h1;
+	}
+	return count;
+}
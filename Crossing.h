@@ -0,0 +1,30 @@
+#ifndef Crossing_h
+#define Crossing_h
+#include "Sun.h"
+#include <stdint.h>
+#include <time.h>
+
+// altitude of a body at a unix time. body is the object passed to findCrossings.
+typedef Real (*AltitudeFunction)(void * body, time_t t);
+
+typedef struct {
+	time_t time;
+	bool rising;
+} Crossing;
+
+Real sunAltitude(void * sun, time_t t);
+Real moonAltitude(void * moon, time_t t);
+
+// finds the times within [start, start + span] seconds at which the altitude crosses
+// threshold. the altitude is sampled every step seconds to bracket the crossings, and
+// each bracket is refined with Brent's method until it is narrower than tolerance
+// seconds. crossings closer together than step may be missed. returns the number of
+// crossings written, at most max.
+// a rate, the largest change of the altitude per second, makes the bracketing safe:
+// between two samples on the same side of the threshold the altitude can only cross it
+// and come back if they are at least (|h0| + |h1|) / rate seconds apart, and only
+// such intervals are split, down to twice the tolerance.
+uint8_t findCrossings(AltitudeFunction altitude, void * body, Real threshold,
+		time_t start, uint32_t span, uint32_t step, uint32_t tolerance,
+		Crossing * crossings, uint8_t max, Real rate=0);
+#endif
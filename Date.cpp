@@ -6,7 +6,7 @@ DaySpan::DaySpan(uint16_t days) {
 }
 
 bool Date::isLeapYear(uint16_t year) {
-	return ((year % 4) == 0) && ((year % 400) == 0);
+	return ((year % 4) == 0 && (year % 100) != 0) || (year % 400) == 0;
 }
 
 uint8_t Date::numDaysInMonth(uint8_t month, uint16_t year) {
@@ -50,6 +50,16 @@ Date::Date(int32_t days_since_epoch) {
 	_day = d;
 }
 
+Date Date::fromKey(uint32_t key) {
+	return Date(key >> 9, (key >> 5) & 0xF, key & 0x1F);
+}
+
+// packs an array of dates, e.g. before sorting them by key
+void Date::keys(Date * dates, uint32_t count, uint32_t * keys) {
+	for (uint32_t i = 0; i < count; i++)
+		keys[i] = dates[i].key();
+}
+
 int32_t Date::daysSinceEpoch() {
 	int32_t res = _day;
 	for (uint8_t m = 1; m < _month; m++)
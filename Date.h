@@ -14,12 +14,16 @@ class Date {
 	public:
 		static bool isLeapYear(uint16_t);
 		static uint8_t numDaysInMonth(uint8_t month, uint16_t year);
+		static Date fromKey(uint32_t key);
+		static void keys(Date * dates, uint32_t count, uint32_t * keys);
 		Date();
 		Date(uint16_t year, uint8_t month, uint8_t day);
 		Date(int32_t days_since_epoch);
 		inline uint16_t year() { return _year; };
 		inline uint8_t month() { return _month; };
 		inline uint8_t day() { return _day; };
+		// year, month and day packed so that keys sort like the dates
+		inline uint32_t key() { return (uint32_t)_year << 9 | (uint32_t)_month << 5 | _day; };
 		int32_t daysSinceEpoch();
 		uint8_t dayOfWeek();
 		const char *monthName();
@@ -8,7 +8,7 @@ DateTime::DateTime() {
 DateTime::DateTime(time_t unixtime) {
 	struct tm t;
 	gmtime_r(&unixtime, &t);
-	_date = Date(t.tm_year + 1870, t.tm_mon + 1, t.tm_mday);
+	_date = Date(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday);
 	_time = Time(t.tm_hour, t.tm_min, t.tm_sec);
 }
 
@@ -17,7 +17,7 @@ int days_from_epoch(int y, int m, int d) {
 	y -= m <= 2;
 	int era = y / 400;
 	int yoe = y - era * 400;								   // [0, 399]
-	int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 0;  // [0, 365]
+	int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;  // [0, 365]
 	int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;		   // [0, 146096]
 	return era * 146097 + doe - 719468;
 }
@@ -0,0 +1,118 @@
+#include "Ephemeris.h"
+#include <math.h>
+
+#define PI M_PI
+#define EPHEMERIS_MAX_DEGREE 31
+
+uint32_t ChebyshevEphemeris::size(uint8_t degree, uint32_t segments) {
+	return sizeof(EphemerisHeader) + segments * 3 * (degree + 1) * sizeof(float);
+}
+
+// right ascension, declination and distance from the series of the body
+static void bodyCoordinates(EphemerisBody body, double d, double * values) {
+	if (body == EPHEMERIS_SUN) {
+		SolarEphemeris e = Sun::ephemeris(d);
+		values[0] = e.rightAscension;
+		values[1] = e.declination;
+		values[2] = 149598000; // distance from Earth to Sun in km, constant in this model
+	} else {
+		MoonCoordinates c = Moon::seriesCoordinates(d);
+		values[0] = c.rightAscension;
+		values[1] = c.declination;
+		values[2] = c.distance;
+	}
+}
+
+// fits each segment by interpolating at the chebyshev nodes. the right ascension is
+// unwrapped within a segment so that the polynomial does not have to follow the jump
+// from PI to -PI. the degree is clamped to EPHEMERIS_MAX_DEGREE and segments are at
+// least a day long.
+void ChebyshevEphemeris::build(void * buffer, EphemerisBody body, int32_t firstDay, uint32_t days,
+		uint16_t segmentDays, uint8_t degree) {
+	if (degree > EPHEMERIS_MAX_DEGREE)
+		degree = EPHEMERIS_MAX_DEGREE;
+	if (segmentDays == 0)
+		segmentDays = 1;
+	EphemerisHeader * header = (EphemerisHeader *)buffer;
+	header->magic = EPHEMERIS_MAGIC;
+	header->version = EPHEMERIS_VERSION;
+	header->body = body;
+	header->degree = degree;
+	header->firstDay = firstDay;
+	header->segmentDays = segmentDays;
+	header->reserved = 0;
+	header->segments = (days + segmentDays - 1) / segmentDays;
+	float * coefficients = (float *)(header + 1);
+	uint8_t n = degree + 1;
+	double samples[3][EPHEMERIS_MAX_DEGREE + 1];
+	for (uint32_t s = 0; s < header->segments; s++) {
+		double start = firstDay + (double)s * segmentDays;
+		for (uint8_t k = 0; k < n; k++) {
+			double x = cos(PI * (k + 0.5) / n);
+			double values[3];
+			bodyCoordinates(body, start + (x + 1) / 2 * segmentDays, values);
+			for (uint8_t q = 0; q < 3; q++)
+				samples[q][k] = values[q];
+			if (k > 0) {
+				while (samples[0][k] - samples[0][k - 1] > PI)
+					samples[0][k] -= 2 * PI;
+				while (samples[0][k] - samples[0][k - 1] < -PI)
+					samples[0][k] += 2 * PI;
+			}
+		}
+		for (uint8_t q = 0; q < 3; q++) {
+			for (uint8_t j = 0; j < n; j++) {
+				double sum = 0;
+				for (uint8_t k = 0; k < n; k++)
+					sum += samples[q][k] * cos(PI * j * (k + 0.5) / n);
+				*coefficients++ = (float)(sum * (j == 0 ? 1.0 : 2.0) / n);
+			}
+		}
+	}
+}
+
+ChebyshevEphemeris::ChebyshevEphemeris(const void * data, uint32_t length) {
+	_header = (const EphemerisHeader *)data;
+	_coefficients = (const float *)(_header + 1);
+	_length = length;
+}
+
+bool ChebyshevEphemeris::valid() {
+	return _length >= sizeof(EphemerisHeader) && _header->magic == EPHEMERIS_MAGIC &&
+			_header->version == EPHEMERIS_VERSION && _header->degree <= EPHEMERIS_MAX_DEGREE &&
+			_header->segmentDays > 0 && _header->body <= EPHEMERIS_MOON &&
+			_header->segments <= (_length - sizeof(EphemerisHeader)) / (3 * (_header->degree + 1) * sizeof(float));
+}
+
+// clenshaw summation of a chebyshev series at x in [-1, 1]
+static Real chebyshev(const float * c, uint8_t n, Real x) {
+	Real b1 = 0, b2 = 0;
+	for (uint8_t j = n - 1; j > 0; j--) {
+		Real b = 2 * x * b1 - b2 + c[j];
+		b2 = b1;
+		b1 = b;
+	}
+	return x * b1 - b2 + c[0];
+}
+
+// returns false when d is outside the fitted range
+bool ChebyshevEphemeris::evaluate(double d, Real * rightAscension, Real * declination, Real * distance) {
+	double offset = d - _header->firstDay;
+	if (offset < 0)
+		return false;
+	uint32_t s = (uint32_t)(offset / _header->segmentDays);
+	if (s >= _header->segments)
+		return false;
+	uint8_t n = _header->degree + 1;
+	const float * c = _coefficients + (uint32_t)s * 3 * n;
+	Real x = (Real)(2 * (offset - (double)s * _header->segmentDays) / _header->segmentDays - 1);
+	Real ra = chebyshev(c, n, x);
+	while (ra > (Real)PI)
+		ra -= 2 * (Real)PI;
+	while (ra <= -(Real)PI)
+		ra += 2 * (Real)PI;
+	*rightAscension = ra;
+	*declination = chebyshev(c + n, n, x);
+	*distance = chebyshev(c + 2 * n, n, x);
+	return true;
+}
@@ -0,0 +1,48 @@
+#ifndef Ephemeris_h
+#define Ephemeris_h
+#include "Sun.h"
+#include <stdint.h>
+
+#define EPHEMERIS_MAGIC 0x48455048 // "HEPH"
+#define EPHEMERIS_VERSION 1
+
+enum EphemerisBody {
+	EPHEMERIS_SUN,
+	EPHEMERIS_MOON
+};
+
+// header of an ephemeris file. it is followed by the coefficients of each segment:
+// degree + 1 floats for the right ascension, then for the declination, then for the
+// distance. values are stored in the byte order of the machine that built the file.
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint8_t body;
+	uint8_t degree;
+	int32_t firstDay; // days since J2000 at the start of the first segment
+	uint16_t segmentDays;
+	uint16_t reserved;
+	uint32_t segments;
+} EphemerisHeader;
+
+// right ascension, declination and distance of the sun or the moon, fitted with a
+// chebyshev polynomial per segment of a few days. the data is a single block that can
+// be built in memory, written to a file and later read or mapped back in; valid() checks
+// the header against the length of the block. degree 8 with 4 day segments for the moon
+// and 32 day segments for the sun keeps the fit within the precision of the stored
+// floats (about 1e-7 rad).
+class ChebyshevEphemeris {
+	public:
+		static uint32_t size(uint8_t degree, uint32_t segments);
+		static void build(void * buffer, EphemerisBody body, int32_t firstDay, uint32_t days,
+				uint16_t segmentDays, uint8_t degree);
+		ChebyshevEphemeris(const void * data, uint32_t length);
+		bool valid();
+		inline EphemerisBody body() { return (EphemerisBody)_header->body; };
+		bool evaluate(double d, Real * rightAscension, Real * declination, Real * distance);
+	private:
+		const EphemerisHeader * _header;
+		const float * _coefficients;
+		uint32_t _length;
+};
+#endif
@@ -0,0 +1,130 @@
+#include "EventStream.h"
+
+#define UNIX_EPOCH_DAY 719163 // days since epoch of 1970-01-01
+#define JERUSALEM_MEAN_TIME 8456 // seconds east of UTC, 35.2354 degrees
+
+static time_t dayStart(int32_t day) {
+	return (time_t)(day - UNIX_EPOCH_DAY) * 86400;
+}
+
+// hours of a molad count from 6 pm of the previous civil day, in Jerusalem mean time
+static time_t moladTime(Molad molad) {
+	return dayStart(molad.day) - 6 * 3600 + (time_t)molad.hour * 3600 + (time_t)molad.parts * 10 / 3 -
+			JERUSALEM_MEAN_TIME;
+}
+
+EventStream::EventStream(ObserverLocation location, int32_t firstDay, int32_t endDay,
+		uint8_t sources, bool diaspora) : _sun(location) {
+	_endDay = endDay;
+	_diaspora = diaspora;
+	_holidayDay = firstDay;
+	_holidayDate = HebrewDate(firstDay);
+	_shabbat = firstDay + (7 - _holidayDate.dayOfWeek()) % 7;
+	_moladMonth = HebrewDate(_holidayDate.year(), _holidayDate.month(), 1);
+	_molad = HebrewDate::molad(_moladMonth.year(), _moladMonth.month());
+	while (moladTime(_molad) < dayStart(firstDay)) {
+		_moladMonth = _moladMonth.addMonths(1);
+		_molad = HebrewDate::moladAfter(_molad, 29, 12, 793);
+	}
+	_sunDay = firstDay;
+	_sunsetPending = false;
+	for (uint8_t s = 0; s < EVENT_SOURCES; s++) {
+		_pending[s] = false;
+		if (sources & (1 << s))
+			advance(s);
+	}
+}
+
+bool EventStream::inRange(int32_t day) {
+	return _endDay == 0 || day < _endDay;
+}
+
+// computes the next event of a source into _events, or clears _pending at the end
+void EventStream::advance(uint8_t source) {
+	CalendarEvent * e = &_events[source];
+	_pending[source] = false;
+	switch (source) {
+		case 0: // holidays, found by walking the days
+			while (inRange(_holidayDay)) {
+				HebrewHoliday holiday = _holidayDate.holiday(_diaspora);
+				int32_t day = _holidayDay++;
+				HebrewDate date = _holidayDate;
+				_holidayDate = _holidayDate.nextDay();
+				if (holiday) {
+					e->time = dayStart(day);
+					e->type = EVENT_HOLIDAY;
+					e->id = holiday;
+					e->additional = 0;
+					e->date = date;
+					_pending[source] = true;
+					return;
+				}
+			}
+			return;
+		case 1: // torah portion of each shabbat, skipping those read on a holiday
+			while (inRange(_shabbat)) {
+				HebrewDate date = HebrewDate(_shabbat);
+				int32_t day = _shabbat;
+				_shabbat += 7;
+				uint8_t portion = date.torahPortion();
+				if (portion) {
+					e->date = date;
+					e->time = dayStart(day);
+					e->type = EVENT_TORAH_PORTION;
+					e->id = portion;
+					e->additional = date.torahPortion(true);
+					_pending[source] = true;
+					return;
+				}
+			}
+			return;
+		case 2: // molads, a mean lunar month apart
+			e->time = moladTime(_molad);
+			if (_endDay != 0 && e->time >= dayStart(_endDay))
+				return;
+			e->type = EVENT_MOLAD;
+			e->id = _moladMonth.month();
+			e->additional = 0;
+			e->date = _moladMonth;
+			_moladMonth = _moladMonth.addMonths(1);
+			_molad = HebrewDate::moladAfter(_molad, 29, 12, 793);
+			_pending[source] = true;
+			return;
+		case 3: // sunrise, then sunset of the same day
+			e->additional = 0;
+			e->id = 0;
+			if (_sunsetPending) {
+				e->time = _sunset;
+				e->type = EVENT_SUNSET;
+				_sunsetPending = false;
+				_pending[source] = true;
+				return;
+			}
+			if (!inRange(_sunDay))
+				return;
+			{
+				Date date = Date(_sunDay);
+				e->date = HebrewDate(_sunDay);
+				e->time = _sun.sunrise(date).unixtime();
+				e->type = EVENT_SUNRISE;
+				_sunset = _sun.sunset(date).unixtime();
+				_sunsetPending = true;
+				_sunDay++;
+				_pending[source] = true;
+			}
+			return;
+	}
+}
+
+// the earliest pending event; false when every source has ended
+bool EventStream::next(CalendarEvent * event) {
+	int8_t best = -1;
+	for (uint8_t s = 0; s < EVENT_SOURCES; s++)
+		if (_pending[s] && (best < 0 || _events[s].time < _events[best].time))
+			best = s;
+	if (best < 0)
+		return false;
+	*event = _events[best];
+	advance(best);
+	return true;
+}
@@ -0,0 +1,64 @@
+#ifndef EventStream_h
+#define EventStream_h
+#include "Sun.h"
+#include "HebrewDate.h"
+#include <stdint.h>
+#include <time.h>
+
+enum CalendarEventType {
+	EVENT_HOLIDAY,
+	EVENT_TORAH_PORTION,
+	EVENT_MOLAD,
+	EVENT_SUNRISE,
+	EVENT_SUNSET
+};
+
+#define EVENT_SOURCES 4
+#define EVENTS_HOLIDAYS (1 << 0)
+#define EVENTS_TORAH_PORTIONS (1 << 1)
+#define EVENTS_MOLADS (1 << 2)
+#define EVENTS_SUN (1 << 3)
+#define EVENTS_ALL 0xF
+
+// an event of the stream. holidays and torah portions are day events at 00:00 UTC of
+// their civil day, with id the HebrewHoliday or TorahPortion and additional the second
+// portion of a double reading. for a molad date is the month it announces.
+typedef struct {
+	time_t time;
+	uint8_t type;
+	uint8_t id;
+	uint8_t additional;
+	HebrewDate date;
+} CalendarEvent;
+
+// calendar and astronomical events for a location in time order, produced on demand.
+// each source keeps one pending event and computes the following one only when that
+// event is taken, and next() returns the earliest pending event of all sources, so a
+// stream with no end costs nothing until it is read.
+class EventStream {
+	public:
+		EventStream(ObserverLocation location, int32_t firstDay, int32_t endDay=0,
+				uint8_t sources=EVENTS_ALL, bool diaspora=false);
+		bool next(CalendarEvent * event);
+	private:
+		Sun _sun;
+		int32_t _endDay; // days since epoch past the last day, 0 for no end
+		bool _diaspora;
+		bool _pending[EVENT_SOURCES];
+		CalendarEvent _events[EVENT_SOURCES];
+		// holidays
+		int32_t _holidayDay;
+		HebrewDate _holidayDate;
+		// torah portions
+		int32_t _shabbat;
+		// molads
+		Molad _molad;
+		HebrewDate _moladMonth;
+		// sun
+		int32_t _sunDay;
+		time_t _sunset;
+		bool _sunsetPending;
+		bool inRange(int32_t day);
+		void advance(uint8_t source);
+};
+#endif
@@ -0,0 +1,178 @@
+#include "Export.h"
+#include "DateTime.h"
+#include <time.h>
+
+EventExporter::EventExporter(EventStream * stream, ExportFormat format, ExportSink sink, void * context,
+		bool hebrew, time_t created) {
+	_stream = stream;
+	_format = format;
+	_sink = sink;
+	_context = context;
+	_hebrew = hebrew;
+	_created = created ? created : time(NULL);
+	_started = false;
+	_ended = false;
+	_count = 0;
+	_used = 0;
+}
+
+void EventExporter::flush() {
+	if (_used > 0)
+		_sink(_context, _buffer, _used);
+	_used = 0;
+}
+
+void EventExporter::append(const char * text) {
+	while (*text) {
+		if (_used == EXPORT_BUFFER)
+			flush();
+		_buffer[_used++] = *text++;
+	}
+}
+
+// text inside a value: ics TEXT escapes backslash, semicolon, comma and newline
+// (RFC 5545 3.3.11), json strings escape quote, backslash and control characters
+void EventExporter::appendText(const char * text) {
+	static const char hex[] = "0123456789abcdef";
+	char escaped[7];
+	for (; *text; text++) {
+		unsigned char c = *text;
+		escaped[0] = '\\';
+		escaped[1] = c;
+		escaped[2] = 0;
+		if (_format == EXPORT_ICS) {
+			if (c == '\n')
+				escaped[1] = 'n';
+			else if (c == '\r')
+				continue;
+			else if (c != '\\' && c != ';' && c != ',') {
+				escaped[0] = c;
+				escaped[1] = 0;
+			}
+		} else if (c < 0x20) {
+			escaped[1] = 'u';
+			escaped[2] = '0';
+			escaped[3] = '0';
+			escaped[4] = hex[c >> 4];
+			escaped[5] = hex[c & 15];
+			escaped[6] = 0;
+		} else if (c != '"' && c != '\\') {
+			escaped[0] = c;
+			escaped[1] = 0;
+		}
+		append(escaped);
+	}
+}
+
+// value with leading zeros to the given number of digits, or as is for 0
+void EventExporter::appendNumber(uint32_t value, uint8_t digits) {
+	char text[11];
+	uint8_t i = sizeof(text) - 1;
+	text[i] = 0;
+	do {
+		text[--i] = '0' + value % 10;
+		value /= 10;
+	} while ((value > 0 || sizeof(text) - 1 - i < digits) && i > 0);
+	append(text + i);
+}
+
+// YYYYMMDD or YYYYMMDDTHHMMSSZ for ics, YYYY-MM-DD or YYYY-MM-DDTHH:MM:SSZ for json
+void EventExporter::appendTime(time_t time, bool day) {
+	DateTime dt = DateTime(time);
+	const char * separator = _format == EXPORT_JSON ? "-" : "";
+	appendNumber(dt.year(), 4);
+	append(separator);
+	appendNumber(dt.month(), 2);
+	append(separator);
+	appendNumber(dt.day(), 2);
+	if (day)
+		return;
+	separator = _format == EXPORT_JSON ? ":" : "";
+	append("T");
+	appendNumber(dt.hour(), 2);
+	append(separator);
+	appendNumber(dt.minute(), 2);
+	append(separator);
+	appendNumber(dt.second(), 2);
+	append("Z");
+}
+
+void EventExporter::appendTitle(CalendarEvent * event) {
+	switch (event->type) {
+		case EVENT_HOLIDAY:
+			appendText(_hebrew ? HebrewDate::holidayName((HebrewHoliday)event->id) :
+					HebrewDate::holidayNameEn((HebrewHoliday)event->id));
+			break;
+		case EVENT_TORAH_PORTION:
+			appendText(_hebrew ? HebrewDate::torahPortionName(event->id) : HebrewDate::torahPortionNameEn(event->id));
+			if (event->additional) {
+				appendText("-");
+				appendText(_hebrew ? HebrewDate::torahPortionName(event->additional) :
+						HebrewDate::torahPortionNameEn(event->additional));
+			}
+			break;
+		case EVENT_MOLAD:
+			appendText(_hebrew ? "מולד " : "Molad ");
+			appendText(_hebrew ? event->date.monthName() : event->date.monthNameEn());
+			break;
+		case EVENT_SUNRISE:
+			appendText(_hebrew ? "זריחה" : "Sunrise");
+			break;
+		case EVENT_SUNSET:
+			appendText(_hebrew ? "שקיעה" : "Sunset");
+			break;
+	}
+}
+
+static const char * _event_types[] = {"holiday", "torah-portion", "molad", "sunrise", "sunset"};
+
+void EventExporter::record(CalendarEvent * event) {
+	bool day = event->type == EVENT_HOLIDAY || event->type == EVENT_TORAH_PORTION;
+	if (_format == EXPORT_ICS) {
+		append("BEGIN:VEVENT\r\nUID:");
+		append(_event_types[event->type]);
+		append("-");
+		appendTime(event->time, false);
+		append("@hebrewcalendar\r\nDTSTAMP:");
+		appendTime(_created, false);
+		append(day ? "\r\nDTSTART;VALUE=DATE:" : "\r\nDTSTART:");
+		appendTime(event->time, day);
+		append("\r\nSUMMARY:");
+		appendTitle(event);
+		append("\r\nEND:VEVENT\r\n");
+	} else {
+		append(_count > 0 ? ",\n{\"type\":\"" : "\n{\"type\":\"");
+		append(_event_types[event->type]);
+		append("\",\"start\":\"");
+		appendTime(event->time, day);
+		append("\",\"title\":\"");
+		appendTitle(event);
+		append("\"}");
+	}
+	_count++;
+}
+
+// exports up to max events, or all of them for 0, and returns how many were written.
+// the header goes out with the first call and the footer when the stream ends, after
+// which the buffer is flushed; a stream without an end must be read with a max.
+uint32_t EventExporter::write(uint32_t max) {
+	if (_ended)
+		return 0;
+	if (!_started) {
+		append(_format == EXPORT_ICS ? "BEGIN:VCALENDAR\r\nVERSION:2.0\r\nPRODID:-//HebrewCalendar//EN\r\n" : "[");
+		_started = true;
+	}
+	CalendarEvent event;
+	uint32_t written = 0;
+	while (max == 0 || written < max) {
+		if (!_stream->next(&event)) {
+			append(_format == EXPORT_ICS ? "END:VCALENDAR\r\n" : "\n]\n");
+			flush();
+			_ended = true;
+			break;
+		}
+		record(&event);
+		written++;
+	}
+	return written;
+}
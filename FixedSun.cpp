@@ -0,0 +1,114 @@
+#include "FixedSun.h"
+
+// sin of the first quadrant in 256 steps, Q15
+static const uint16_t SINE[257] = {
+	0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+	2411, 2611, 2811, 3012, 3212, 3412, 3612, 3812, 4011, 4211, 4410, 4609,
+	4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6787, 6983,
+	7180, 7376, 7571, 7767, 7962, 8157, 8351, 8546, 8740, 8933, 9127, 9319,
+	9512, 9704, 9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+	11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+	14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269, 15447, 15624, 15800, 15976,
+	16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+	18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001,
+	20160, 20318, 20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+	22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312, 23453, 23593,
+	23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+	25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674,
+	26791, 26906, 27020, 27133, 27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+	28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+	29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+	30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050,
+	31114, 31177, 31238, 31298, 31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+	31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251,
+	32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+	32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753,
+	32758, 32762, 32766, 32767, 32768
+};
+
+#define QUARTER 0x40000000
+
+#define FIXED_M0 4265488311u // mean anomaly at J2000, 357.5291 degrees
+#define FIXED_RATE 11758669u // mean motion per day, 0.98560028 degrees
+#define FIXED_RATE_FRACTION 5895 // fractional part of FIXED_RATE, Q14
+#define FIXED_PERIHELION 3375572280u // 102.9372 degrees plus half a turn
+#define FIXED_SIN_E 13035 // sin of the obliquity of the Earth, Q15
+#define FIXED_SIN_H0 -15610145 // sin of -0.833 degrees, Q30
+#define FIXED_J0 15099 // 0.0009 days, Q24
+#define FIXED_DAY 730121 // R.D. day number of J2000
+#define FIXED_J2000 946728000 // unix time of J2000
+
+// Q15 sine of a binary angle
+int32_t fixedSin(uint32_t angle) {
+	uint32_t r = angle & (QUARTER - 1);
+	if (angle & QUARTER)
+		r = QUARTER - r;
+	uint16_t i = r >> 22;
+	int32_t s = SINE[i];
+	if (i < 256)
+		s += ((int32_t)(SINE[i + 1] - SINE[i]) * (int32_t)((r >> 6) & 0xFFFF)) >> 16;
+	return angle & 0x80000000 ? -s : s;
+}
+
+// binary angle of the arc sine of a Q15 value, by bisecting the table
+int32_t fixedAsin(int32_t x) {
+	bool negative = x < 0;
+	if (negative)
+		x = -x;
+	if (x >= 32768)
+		return negative ? -QUARTER : QUARTER;
+	uint16_t low = 0, high = 256;
+	while (high - low > 1) {
+		uint16_t middle = (low + high) >> 1;
+		if (SINE[middle] <= x)
+			low = middle;
+		else
+			high = middle;
+	}
+	int32_t a = ((int32_t)low << 22) + (int32_t)(((uint32_t)(x - SINE[low]) << 22) / (SINE[high] - SINE[low]));
+	return negative ? -a : a;
+}
+
+static uint16_t isqrt(uint32_t n) {
+	uint32_t root = 0;
+	for (uint32_t bit = (uint32_t)1 << 30; bit; bit >>= 2) {
+		if (n >= root + bit) {
+			n -= root + bit;
+			root = (root >> 1) + bit;
+		} else
+			root >>= 1;
+	}
+	return root;
+}
+
+// sunrise and sunset as unix times on the given day (days since epoch, as in Date)
+// at the given binary angle latitude and longitude. in polar day and night the hour
+// angle is clamped, so both times meet at the transit or lie half a day from it.
+void fixedSunTimes(int32_t day, int32_t latitude, int32_t longitude, time_t * sunrise, time_t * sunset) {
+	// transit day since J2000 as a whole day n plus a fraction, as julianCycle and approxTransit
+	int32_t lon = longitude >> 8;
+	int32_t n = day - FIXED_DAY + ((0x1000000 - FIXED_J0 + lon) >> 24);
+	int32_t fraction = FIXED_J0 - lon;
+	uint32_t M = FIXED_M0 + (uint32_t)n * FIXED_RATE + (uint32_t)((n * FIXED_RATE_FRACTION) >> 14) +
+			(uint32_t)(((fraction >> 8) * (int32_t)(FIXED_RATE >> 8)) >> 8);
+	int32_t sinM = fixedSin(M);
+	int32_t C = (sinM * 22309 + fixedSin(2 * M) * 233 + fixedSin(3 * M) * 3) >> 5; // equation of center
+	uint32_t L = M + (uint32_t)C + FIXED_PERIHELION;
+	int32_t sinDec = (fixedSin(L) * FIXED_SIN_E) >> 15;
+	int32_t cosDec = isqrt(((uint32_t)1 << 30) - (uint32_t)(sinDec * sinDec));
+	// equation of time, Q24 days
+	fraction += (sinM * 22230 - fixedSin(2 * L) * 28941) >> 13;
+	// hour angle
+	int32_t sinPhi = fixedSin(latitude);
+	int32_t cosPhi = fixedSin((uint32_t)latitude + QUARTER);
+	int32_t numerator = FIXED_SIN_H0 - sinPhi * sinDec;
+	int32_t denominator = (cosPhi * cosDec) >> 15;
+	int32_t x = denominator > 0 ? numerator / denominator : numerator;
+	if (denominator <= 0 || x > 32768 || x < -32768)
+		x = numerator < 0 ? -32768 : 32768;
+	uint32_t w = QUARTER - fixedAsin(x);
+	int32_t half = ((w >> 10) * 675) >> 15; // seconds, 86400 = 675 << 7
+	time_t noon = FIXED_J2000 + (time_t)n * 86400 + (((fraction >> 4) * 675) >> 13);
+	*sunrise = noon - half;
+	*sunset = noon + half;
+}
@@ -0,0 +1,29 @@
+#ifndef FixedSun_h
+#define FixedSun_h
+#include "Sun.h"
+#include <stdint.h>
+#include <time.h>
+
+// integer sunrise and sunset for targets without an FPU. the chain is the one of
+// Sun::sunrise (mean anomaly, ecliptic longitude, declination, hour angle, transit),
+// evaluated on binary angles (a full turn is 2^32, so angle sums wrap for free), Q15
+// sines from a quarter wave table with linear interpolation, and day fractions in Q24.
+// the results stay within 10 seconds of the floating point ones up to 65 degrees of
+// latitude. closer to the polar circles the day length is so sensitive to the Q15
+// rounding that the error grows to a minute and a half. defining SUN_FIXED_POINT makes
+// Sun::sunrise and Sun::sunset use it up to FIXED_SUN_MAX_LATITUDE, and the floating
+// point chain past it.
+
+// 65 degrees as a binary angle
+#define FIXED_SUN_MAX_LATITUDE 775480206
+
+// binary angle of an angle in degrees, |degrees| <= 360. a multiplication and a
+// conversion, with angles past half a turn wrapping to negative ones through 64 bits.
+inline int32_t fixedAngle(Real degrees) {
+	return (int32_t)(uint32_t)(int64_t)(degrees * (Real)11930464.711111111);
+}
+
+int32_t fixedSin(uint32_t angle);
+int32_t fixedAsin(int32_t x);
+void fixedSunTimes(int32_t day, int32_t latitude, int32_t longitude, time_t * sunrise, time_t * sunset);
+#endif
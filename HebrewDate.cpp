@@ -19,15 +19,34 @@ uint8_t HebrewDate::numMonthsInYear(uint16_t year) {
 		return 12;
 }
 
-uint32_t HebrewDate::yearElapsedDays(uint16_t year) {
+// months from the epoch to Tishrei of the given year, 235 in every 19 year cycle
+uint32_t HebrewDate::monthsElapsed(uint16_t year) {
 	uint32_t months_elapsed = (uint32_t)235 * ldiv(year - 1, 19).quot;
 	months_elapsed += 12 * ((year - 1) % 19);
 	months_elapsed += ldiv(((((year - 1) % 19) * 7) + 1), 19).quot;
+	return months_elapsed;
+}
+
+// position of the month in its year, counting from Tishrei = 0
+uint8_t HebrewDate::monthIndex(uint16_t year, uint8_t month) {
+	if (month >= 7)
+		return month - 7;
+	return month + numMonthsInYear(year) - 7;
+}
+
+// day of the molad counted as in yearElapsedDays, and the parts since the start
+// of that day, for the month with the given number of months since the epoch
+void HebrewDate::moladElapsed(uint32_t months_elapsed, uint32_t * day, uint32_t * parts) {
 	uint32_t parts_elapsed = ((months_elapsed % 1080) * 793) + 204;
 	uint32_t hours_elapsed = 5 + (months_elapsed * 12) + \
 			(ldiv(months_elapsed, 1080).quot * 793) + ldiv(parts_elapsed, 1080).quot;
-	uint32_t day = 1 + (29 * months_elapsed) + ldiv(hours_elapsed, 24).quot;
-	uint32_t parts = ((hours_elapsed % 24) * 1080) + (parts_elapsed % 1080);
+	*day = 1 + (29 * months_elapsed) + ldiv(hours_elapsed, 24).quot;
+	*parts = ((hours_elapsed % 24) * 1080) + (parts_elapsed % 1080);
+}
+
+uint32_t HebrewDate::yearElapsedDays(uint16_t year) {
+	uint32_t day, parts;
+	moladElapsed(monthsElapsed(year), &day, &parts);
 	uint32_t alt_day;
 	if (parts >= 19440 || \
 			(day % 7 == 2 && parts >= 9924 && !isLeapYear(year)) || \
@@ -40,6 +59,65 @@ uint32_t HebrewDate::yearElapsedDays(uint16_t year) {
 	return alt_day;
 }
 
+Molad HebrewDate::molad(uint16_t year, uint8_t month) {
+	uint32_t day, parts;
+	moladElapsed(monthsElapsed(year) + monthIndex(year, month), &day, &parts);
+	Molad m;
+	m.day = (int32_t)day - 1373428;
+	m.dayOfWeek = day % 7 + 1;
+	m.hour = parts / 1080;
+	m.parts = parts % 1080;
+	return m;
+}
+
+// molads of count consecutive months, starting with the given one. each is the
+// previous one plus a mean lunar month of 29 days, 12 hours and 793 parts.
+void HebrewDate::molads(uint16_t year, uint8_t month, uint16_t count, Molad * molads) {
+	if (count == 0)
+		return;
+	molads[0] = molad(year, month);
+	for (uint16_t i = 1; i < count; i++)
+		molads[i] = moladAfter(molads[i - 1], 29, 12, 793);
+}
+
+// the given molad moved forward by a span of time, e.g. 3 days for the earliest and
+// 14 days, 18 hours and 396 parts for the latest time of kiddush levana
+Molad HebrewDate::moladAfter(Molad molad, uint16_t days, uint8_t hours, uint16_t parts) {
+	uint32_t p = (uint32_t)molad.hour * 1080 + molad.parts + (uint32_t)hours * 1080 + parts;
+	uint32_t d = days + p / 25920;
+	p %= 25920;
+	Molad m;
+	m.day = molad.day + d;
+	m.dayOfWeek = (molad.dayOfWeek - 1 + d) % 7 + 1;
+	m.hour = p / 1080;
+	m.parts = p % 1080;
+	return m;
+}
+
+// the molad as a civil date and time in Jerusalem mean time, which is how it is announced.
+// a part is 10/3 seconds; the date is converted with integer arithmetic only.
+// Algorithm: http://howardhinnant.github.io/date_algorithms.html
+DateTime HebrewDate::moladDateTime(Molad molad) {
+	int32_t z = molad.day;
+	uint8_t hour = molad.hour + 18;
+	if (hour < 24)
+		z -= 1;
+	else
+		hour -= 24;
+	// days since 0000-03-01 in the proleptic gregorian calendar
+	z -= 1 - 306;
+	int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+	uint32_t doe = z - era * 146097;
+	uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	uint32_t mp = (5 * doy + 2) / 153;
+	uint8_t d = doy - (153 * mp + 2) / 5 + 1;
+	uint8_t m = mp < 10 ? mp + 3 : mp - 9;
+	uint16_t y = yoe + era * 400 + (m <= 2);
+	uint32_t seconds = (uint32_t)molad.parts * 10 / 3;
+	return DateTime(Date(y, m, d), Time(hour, seconds / 60, seconds % 60));
+}
+
 uint16_t HebrewDate::numDaysInYear(uint16_t year) {
 	return (yearElapsedDays(year + 1) - yearElapsedDays(year));
 }
@@ -99,6 +177,145 @@ DaySpan HebrewDate::operator - (HebrewDate& d) {
 	return DaySpan(daysSinceEpoch() - d.daysSinceEpoch());
 }
 
+// the following day, found from the month lengths instead of through the day count
+HebrewDate HebrewDate::nextDay() {
+	if (_day < numDaysInMonth(_year, _month))
+		return HebrewDate(_year, _month, _day + 1);
+	if (_month == 6) // Elul
+		return HebrewDate(_year + 1, 7, 1);
+	if (_month == numMonthsInYear(_year))
+		return HebrewDate(_year, 1, 1);
+	return HebrewDate(_year, _month + 1, 1);
+}
+
+HebrewDate HebrewDate::fromKey(uint32_t key) {
+	uint8_t order = (key >> 5) & 0xF;
+	return HebrewDate(key >> 9, order < 7 ? order + 7 : order - 6, key & 0x1F);
+}
+
+// packs an array of dates, e.g. before sorting them by key
+void HebrewDate::keys(HebrewDate * dates, uint32_t count, uint32_t * keys) {
+	for (uint32_t i = 0; i < count; i++)
+		keys[i] = dates[i].key();
+}
+
+// day of the month with the given number of months since the epoch, clamped to the
+// length of that month
+HebrewDate HebrewDate::fromMonth(uint32_t months, uint8_t day) {
+	uint16_t year = (uint16_t)((uint64_t)months * 19 / 235) + 1;
+	if (monthsElapsed(year + 1) <= months)
+		year++;
+	else if (monthsElapsed(year) > months)
+		year--;
+	uint8_t index = months - monthsElapsed(year);
+	uint8_t count = numMonthsInYear(year);
+	uint8_t month = index < count - 6 ? index + 7 : index + 7 - count;
+	uint8_t length = numDaysInMonth(year, month);
+	return HebrewDate(year, month, day > length ? length : day);
+}
+
+// the same day the given number of months later (or earlier when negative), counting
+// Adar I and Adar II as two months. a 30th becomes the 29th in a short month.
+HebrewDate HebrewDate::addMonths(int32_t months) {
+	return fromMonth(monthsElapsed(_year) + monthIndex(_year, _month) + months, _day);
+}
+
+// the same month and day in another year. Adar of a common year becomes Adar II in a
+// leap year, and Adar I or Adar II become Adar in a common year.
+HebrewDate HebrewDate::addYears(int16_t years) {
+	uint16_t year = _year + years;
+	uint8_t month = _month;
+	if (month == 13 && !isLeapYear(year))
+		month = 12;
+	else if (month == 12 && !isLeapYear(_year) && isLeapYear(year))
+		month = 13;
+	uint8_t length = numDaysInMonth(year, month);
+	return HebrewDate(year, month, _day > length ? length : _day);
+}
+
+// whole years, then whole months, then days from one date to another, so that adding
+// them in that order to from gives to. negative when to is before from.
+HebrewSpan HebrewDate::difference(HebrewDate from, HebrewDate to) {
+	HebrewSpan span;
+	if (to.key() < from.key()) {
+		span = difference(to, from);
+		span.years = -span.years;
+		span.months = -span.months;
+		span.days = -span.days;
+		return span;
+	}
+	int16_t years = to._year - from._year;
+	HebrewDate a = from.addYears(years);
+	if (a.key() > to.key())
+		a = from.addYears(--years);
+	int32_t months = (int32_t)(monthsElapsed(to._year) + monthIndex(to._year, to._month)) -
+			(int32_t)(monthsElapsed(a._year) + monthIndex(a._year, a._month));
+	HebrewDate b = a.addMonths(months);
+	if (b.key() > to.key())
+		b = a.addMonths(--months);
+	span.years = years;
+	span.months = months;
+	span.days = to.daysSinceEpoch() - b.daysSinceEpoch();
+	return span;
+}
+
+// days since epoch of the first day of each month of the year, indexed by month
+void HebrewDate::monthStarts(uint16_t year, int32_t * starts) {
+	uint8_t count = numMonthsInYear(year);
+	int32_t day = yearElapsedDays(year) + 1 - 1373429;
+	for (uint8_t i = 0; i < count; i++) {
+		uint8_t month = i < count - 6 ? i + 7 : i + 7 - count;
+		starts[month] = day;
+		day += numDaysInMonth(year, month);
+	}
+}
+
+// days since epoch of the anniversary of each date of death in the given year, with
+// the rules of Reingold and Dershowitz, Calendrical Calculations: a 30th of Cheshvan
+// or Kislev that was not followed by a 30th in the next year falls on the last day of
+// the month, Adar II stays in the last month, and a 30th of Adar I in a common year
+// becomes the 30th of Shevat. the layout of the year is computed once; the per-record
+// work is a table lookup and is split across threads when built with OpenMP.
+void HebrewDate::yahrzeits(const HebrewDate * dates, uint32_t count, uint16_t year, int32_t * days) {
+	int32_t starts[14];
+	monthStarts(year, starts);
+	bool leap = isLeapYear(year);
+	uint8_t last = leap ? 13 : 12;
+#ifdef _OPENMP
+	#pragma omp parallel for
+#endif
+	for (int32_t i = 0; i < (int32_t)count; i++) {
+		HebrewDate d = dates[i];
+		if (d._month == 8 && d._day == 30 && !isLongHeshvanYear(d._year + 1))
+			days[i] = starts[9] - 1;
+		else if (d._month == 9 && d._day == 30 && isShortKislevYear(d._year + 1))
+			days[i] = starts[10] - 1;
+		else if (d._month == 13)
+			days[i] = starts[last] + d._day - 1;
+		else if (d._month == 12 && d._day == 30 && !leap)
+			days[i] = starts[11] + 29;
+		else
+			days[i] = starts[d._month] + d._day - 1;
+	}
+}
+
+// days since epoch of each birthday in the given year. a birthday in the last month of
+// its year (Adar, or Adar II) is kept in the last month; a 30th in a 29 day month moves
+// to the first of the next month.
+void HebrewDate::birthdays(const HebrewDate * dates, uint32_t count, uint16_t year, int32_t * days) {
+	int32_t starts[14];
+	monthStarts(year, starts);
+	uint8_t last = isLeapYear(year) ? 13 : 12;
+#ifdef _OPENMP
+	#pragma omp parallel for
+#endif
+	for (int32_t i = 0; i < (int32_t)count; i++) {
+		HebrewDate d = dates[i];
+		uint8_t month = d._month == numMonthsInYear(d._year) ? last : d._month;
+		days[i] = starts[month] + d._day - 1;
+	}
+}
+
 void HebrewDate::yearNumber(char * buf) {
 	int2heb(_year, buf, true);
 }
@@ -178,7 +395,7 @@ const char *HebrewDate::dayOfWeekName() {
 }
 
 HebrewHoliday HebrewDate::holiday(bool diaspora) {
-	HebrewHoliday holiday;
+	HebrewHoliday holiday = (HebrewHoliday)0;
 	// Nisan
 	if (_month == 1) {
 		if (_day == 15)
@@ -471,6 +688,15 @@ static const char *_holiday_names[] {
 	"שושן פורים קטן"
 };
 
+// names by id, pointing into the same tables as the member functions
+const char *HebrewDate::holidayName(HebrewHoliday holiday) {
+	return _holiday_names[holiday];
+}
+
+const char *HebrewDate::holidayNameEn(HebrewHoliday holiday) {
+	return _holiday_names_en[holiday];
+}
+
 const char *HebrewDate::holidayName() {
 	return _holiday_names[holiday()];
 }
@@ -549,6 +775,14 @@ uint8_t HebrewDate::torahPortion(bool additional) {
 	return _torah_portions[yeartype][weekno][(additional ? 1 : 0)];
 }
 
+const char * HebrewDate::torahPortionName(uint8_t portion) {
+	return _torah_portion_names[portion];
+}
+
+const char * HebrewDate::torahPortionNameEn(uint8_t portion) {
+	return _torah_portion_names_en[portion];
+}
+
 const char * HebrewDate::torahPortionNameEn() {
 	return _torah_portion_names_en[torahPortion()];
 }
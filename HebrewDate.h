@@ -2,6 +2,7 @@
 #define HebrewDate_h
 
 #include "Date.h"
+#include "DateTime.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -68,6 +69,22 @@ enum YearType {
 	Y7S5
 };
 
+// the mean new moon of a month. hours count from 6 pm at the start of the hebrew day,
+// parts (chalakim) are 1080 to the hour.
+typedef struct {
+	int32_t day; // days since epoch of the hebrew day the molad falls on
+	uint8_t dayOfWeek;
+	uint8_t hour;
+	uint16_t parts;
+} Molad;
+
+// a distance between two hebrew dates, as counted by HebrewDate::difference
+typedef struct {
+	int16_t years;
+	int8_t months;
+	int8_t days;
+} HebrewSpan;
+
 class HebrewDate {
 	public:
 		static bool isLeapYear(uint16_t year);
@@ -79,17 +96,38 @@ class HebrewDate {
 		static uint8_t yearType(uint16_t year);
 		static const char * yearTypeName(uint16_t year);
 		static const char * yearTypeNameEn(uint16_t year);
+		static Molad molad(uint16_t year, uint8_t month);
+		static void molads(uint16_t year, uint8_t month, uint16_t count, Molad * molads);
+		static Molad moladAfter(Molad molad, uint16_t days, uint8_t hours, uint16_t parts);
+		static DateTime moladDateTime(Molad molad);
+		static const char * holidayName(HebrewHoliday holiday);
+		static const char * holidayNameEn(HebrewHoliday holiday);
+		static const char * torahPortionName(uint8_t portion);
+		static const char * torahPortionNameEn(uint8_t portion);
+		static HebrewDate fromKey(uint32_t key);
+		static void keys(HebrewDate * dates, uint32_t count, uint32_t * keys);
+		static HebrewSpan difference(HebrewDate from, HebrewDate to);
+		static void yahrzeits(const HebrewDate * dates, uint32_t count, uint16_t year, int32_t * days);
+		static void birthdays(const HebrewDate * dates, uint32_t count, uint16_t year, int32_t * days);
 		HebrewDate();
 		HebrewDate(uint16_t year, uint8_t month, uint8_t day);
 		HebrewDate(int32_t daysSinceEpoch);
 		inline uint8_t day() { return _day; };
 		inline uint8_t month() { return _month; };
 		inline uint16_t year() { return _year; };
+		// year, month in calendar order (Tishrei 0 to Adar II 6, Nisan 7 to Elul 12) and
+		// day packed so that keys sort like the dates
+		inline uint32_t key() {
+			return (uint32_t)_year << 9 | (uint32_t)(_month >= 7 ? _month - 7 : _month + 6) << 5 | _day;
+		};
 		bool operator < (HebrewDate& d);
 		bool operator > (HebrewDate& d);
 		HebrewDate operator + (DaySpan dayspan);
 		HebrewDate operator - (DaySpan dayspan);
 		DaySpan operator - (HebrewDate& d);
+		HebrewDate nextDay();
+		HebrewDate addMonths(int32_t months);
+		HebrewDate addYears(int16_t years);
 		int32_t daysSinceEpoch();
 		uint8_t dayOfWeek();
 		HebrewHoliday holiday(bool diaspora=false);
@@ -106,6 +144,11 @@ class HebrewDate {
 		const char * additionalTorahPortionName();
 		const char * additionalTorahPortionNameEn();
 	private:
+		static uint32_t monthsElapsed(uint16_t year);
+		static uint8_t monthIndex(uint16_t year, uint8_t month);
+		static HebrewDate fromMonth(uint32_t months, uint8_t day);
+		static void monthStarts(uint16_t year, int32_t * starts);
+		static void moladElapsed(uint32_t months, uint32_t * day, uint32_t * parts);
 		static uint32_t yearElapsedDays(uint16_t year);
 		uint16_t _year;
 		uint8_t _month;
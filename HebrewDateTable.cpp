@@ -0,0 +1,54 @@
+#include "HebrewDateTable.h"
+#include <stddef.h>
+
+uint32_t HebrewDateTable::size(uint32_t days) {
+	return sizeof(HebrewDateTableHeader) + days * sizeof(uint32_t);
+}
+
+// buffer must hold size(days) bytes. the date is converted once and then advanced with
+// nextDay, and each day's holiday is taken from holiday().
+void HebrewDateTable::build(void * buffer, int32_t firstDay, uint32_t days, bool diaspora) {
+	HebrewDateTableHeader * header = (HebrewDateTableHeader *)buffer;
+	uint32_t * entries = (uint32_t *)(header + 1);
+	HebrewDate date = HebrewDate(firstDay);
+	header->magic = HEBREW_DATE_TABLE_MAGIC;
+	header->version = HEBREW_DATE_TABLE_VERSION;
+	header->diaspora = diaspora;
+	header->reserved = 0;
+	header->firstDay = firstDay;
+	header->days = days;
+	header->firstYear = date.year();
+	header->reserved2 = 0;
+	uint8_t dayOfWeek = date.dayOfWeek();
+	for (uint32_t i = 0; i < days; i++) {
+		entries[i] = (uint32_t)date.day() | (uint32_t)date.month() << 5 | (uint32_t)dayOfWeek << 9 |
+				(uint32_t)date.holiday(diaspora) << 12 | (uint32_t)(date.year() - header->firstYear) << 18;
+		date = date.nextDay();
+		dayOfWeek = dayOfWeek == 7 ? 1 : dayOfWeek + 1;
+	}
+}
+
+HebrewDateTable::HebrewDateTable(const void * data, uint32_t length) {
+	_header = (const HebrewDateTableHeader *)data;
+	_entries = (const uint32_t *)(_header + 1);
+	_length = length;
+}
+
+bool HebrewDateTable::valid() {
+	return _length >= sizeof(HebrewDateTableHeader) && _header->magic == HEBREW_DATE_TABLE_MAGIC &&
+			_header->version == HEBREW_DATE_TABLE_VERSION &&
+			_header->days <= (_length - sizeof(HebrewDateTableHeader)) / sizeof(uint32_t);
+}
+
+// returns false when the day is outside the table
+bool HebrewDateTable::lookup(int32_t day, HebrewDate * date, HebrewHoliday * holiday, uint8_t * dayOfWeek) {
+	uint32_t e = entry(day);
+	if (e == 0)
+		return false;
+	*date = HebrewDate(_header->firstYear + HEBREW_ENTRY_YEAR_OFFSET(e), HEBREW_ENTRY_MONTH(e), HEBREW_ENTRY_DAY(e));
+	if (holiday)
+		*holiday = HEBREW_ENTRY_HOLIDAY(e);
+	if (dayOfWeek)
+		*dayOfWeek = HEBREW_ENTRY_DAY_OF_WEEK(e);
+	return true;
+}
@@ -0,0 +1,52 @@
+#ifndef HebrewDateTable_h
+#define HebrewDateTable_h
+#include "HebrewDate.h"
+#include <stdint.h>
+
+#define HEBREW_DATE_TABLE_MAGIC 0x54444248 // "HBDT"
+#define HEBREW_DATE_TABLE_VERSION 1
+
+// header of a hebrew date table, followed by one packed entry per day. entries are
+// stored in the byte order of the machine that built the table.
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint8_t diaspora;
+	uint8_t reserved;
+	int32_t firstDay; // days since epoch of the first entry, as HebrewDate(int32_t)
+	uint32_t days;
+	uint16_t firstYear; // hebrew year of the first entry
+	uint16_t reserved2;
+} HebrewDateTableHeader;
+
+// entry bits: day 0-4, month 5-8, day of week 9-11, holiday 12-17, year - firstYear 18-31
+#define HEBREW_ENTRY_DAY(e) ((uint8_t)((e) & 0x1F))
+#define HEBREW_ENTRY_MONTH(e) ((uint8_t)(((e) >> 5) & 0xF))
+#define HEBREW_ENTRY_DAY_OF_WEEK(e) ((uint8_t)(((e) >> 9) & 0x7))
+#define HEBREW_ENTRY_HOLIDAY(e) ((HebrewHoliday)(((e) >> 12) & 0x3F))
+#define HEBREW_ENTRY_YEAR_OFFSET(e) ((uint16_t)((e) >> 18))
+
+// hebrew date, day of week and holiday of every day in a range, packed into four bytes
+// per day, so a conversion with its holiday is a single load. the table is one block
+// that is used in memory as built or written to a file and read or mapped back in;
+// valid() checks the header against the length of the block. 1800 to 2300 CE takes
+// 183k entries, about 730 KB.
+class HebrewDateTable {
+	public:
+		static uint32_t size(uint32_t days);
+		static void build(void * buffer, int32_t firstDay, uint32_t days, bool diaspora=false);
+		HebrewDateTable(const void * data, uint32_t length);
+		bool valid();
+		bool lookup(int32_t day, HebrewDate * date, HebrewHoliday * holiday=NULL, uint8_t * dayOfWeek=NULL);
+		inline uint16_t firstYear() { return _header->firstYear; };
+		// the packed entry of a day, 0 when the day is outside the table
+		inline uint32_t entry(int32_t day) {
+			uint32_t i = (uint32_t)(day - _header->firstDay);
+			return i < _header->days ? _entries[i] : 0;
+		};
+	private:
+		const HebrewDateTableHeader * _header;
+		const uint32_t * _entries;
+		uint32_t _length;
+};
+#endif
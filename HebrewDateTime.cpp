@@ -4,41 +4,168 @@
 HebrewDateTime::HebrewDateTime() {
 }
 
+HebrewDateTime::HebrewDateTime(HebrewDate date, uint8_t hour, float parts) {
+	_date = date;
+	_hour = hour;
+	_parts = parts;
+}
+
 HebrewDateTime::HebrewDateTime(DateTime datetime, ObserverLocation location) {
-	_date = HebrewDate(datetime.date().daysSinceEpoch() + 1);
-	Sun sun = Sun(location);
-	Date today = datetime.date();
-	Time now = datetime.time();
-	Date yesterday = today - DaySpan(1);
-	Date tomorrow = today + DaySpan(1);
-
-	Time yesterdaySunset = sun.sunset(yesterday).time() + HourSpan(2);
-	Time todaySunrise = sun.sunrise(today).time() + HourSpan(2);
-	Time todaySunset = sun.sunset(today).time() + HourSpan(2);
-	Time tomorrowSunrise = sun.sunrise(tomorrow).time() + HourSpan(2);
-
-	uint32_t daylen = 0, nightlen = 0;
-	uint32_t secs;
+	HebrewDay day = HebrewDay(location);
+	*this = day.at(datetime);
+}
+
+HebrewDay::HebrewDay(ObserverLocation location) : _sun(location) {
+	_valid = false;
+}
+
+void HebrewDay::update(Date date) {
+	int32_t days = date.daysSinceEpoch();
+	if (_valid && days == _days)
+		return;
+	if (_valid && days == _days + 1) {
+		// the next day: yesterday's sunset and today's sunrise are known
+		_yesterdaySunset = _todaySunset;
+		_todaySunrise = _tomorrowSunrise;
+		_before = _after;
+	} else {
+		_yesterdaySunset = (_sun.sunset(date - DaySpan(1)).time() + HourSpan(2)).secondsSinceMidnight();
+		_todaySunrise = (_sun.sunrise(date).time() + HourSpan(2)).secondsSinceMidnight();
+		_before = HebrewDate(days);
+	}
+	_todaySunset = (_sun.sunset(date).time() + HourSpan(2)).secondsSinceMidnight();
+	_tomorrowSunrise = (_sun.sunrise(date + DaySpan(1)).time() + HourSpan(2)).secondsSinceMidnight();
+	_after = _before.nextDay();
+	_date = date;
+	_days = days;
+	_valid = true;
+}
+
+// hours 0 to 11 are the night, counted from sunset, and 12 to 23 the day
+HebrewDateTime HebrewDay::at(Time time) {
+	uint32_t now = time.secondsSinceMidnight();
 	double hour;
-	if (now > todaySunset) {
+	if (now >= _todaySunset) {
 		// sunset to midnight
-		nightlen = tomorrowSunrise.secondsSinceMidnight() + 86400 - todaySunset.secondsSinceMidnight();
-		secs = now.secondsSinceMidnight() - todaySunset.secondsSinceMidnight();
-		hour = (double)secs / nightlen * 12;
-		_hour = int(hour);
-		_date = _date + DaySpan(1);
-	} else if (now < todaySunrise) {
+		hour = (double)(now - _todaySunset) / (_tomorrowSunrise + 86400 - _todaySunset) * 12;
+		return HebrewDateTime(_after, int(hour), hour - int(hour));
+	}
+	if (now < _todaySunrise) {
 		// midnight to sunrise
-		nightlen = 86400 - yesterdaySunset.secondsSinceMidnight() + todaySunrise.secondsSinceMidnight();
-		secs = 86400 - yesterdaySunset.secondsSinceMidnight() + now.secondsSinceMidnight();
-		hour = (double)secs / nightlen * 12;
-		_hour = int(hour);
+		hour = (double)(86400 - _yesterdaySunset + now) / (86400 - _yesterdaySunset + _todaySunrise) * 12;
+		return HebrewDateTime(_before, int(hour), hour - int(hour));
+	}
+	// sunrise to sunset
+	hour = (double)(now - _todaySunrise) / (_todaySunset - _todaySunrise) * 12;
+	return HebrewDateTime(_before, 12 + int(hour), hour - int(hour));
+}
+
+HebrewDateTime HebrewDay::at(DateTime datetime) {
+	update(datetime.date());
+	return at(datetime.time());
+}
+
+// seconds relative to midnight starting the date, which are negative before midnight
+DateTime HebrewDay::civil(int32_t seconds) {
+	if (seconds < 0)
+		return DateTime(_date - DaySpan(1), Time((uint32_t)(seconds + 86400)));
+	return DateTime(_date, Time((uint32_t)seconds));
+}
+
+// start of the given seasonal hour, plus the given fraction of it
+DateTime HebrewDay::datetime(uint8_t hour, float parts) {
+	if (hour < 12) {
+		uint32_t night = 86400 - _yesterdaySunset + _todaySunrise;
+		return civil((int32_t)_yesterdaySunset - 86400 + (int32_t)((hour + parts) * night / 12));
+	}
+	uint32_t day = _todaySunset - _todaySunrise;
+	return civil((int32_t)_todaySunrise + (int32_t)((hour - 12 + parts) * day / 12));
+}
+
+// start of each of the 24 seasonal hours; the last one ends at todaySunset()
+void HebrewDay::hours(DateTime * starts) {
+	uint32_t night = 86400 - _yesterdaySunset + _todaySunrise;
+	uint32_t day = _todaySunset - _todaySunrise;
+	for (uint8_t h = 0; h < 12; h++) {
+		starts[h] = civil((int32_t)_yesterdaySunset - 86400 + (int32_t)(h * night / 12));
+		starts[h + 12] = civil((int32_t)_todaySunrise + (int32_t)(h * day / 12));
+	}
+}
+
+HebrewClock::HebrewClock(ObserverLocation location) : _sun(location) {
+}
+
+void HebrewClock::start(DateTime datetime) {
+	HebrewDay day = HebrewDay(_sun.observer());
+	day.update(datetime.date());
+	uint32_t now = datetime.time().secondsSinceMidnight();
+	_sunriseDate = datetime.date();
+	if (now >= day.todaySunset()) {
+		_daytime = false;
+		_date = day.after();
+		_boundary = day.todaySunset();
+		_length = day.tomorrowSunrise() + 86400 - day.todaySunset();
+		_sunriseDate = _sunriseDate + DaySpan(1);
+		seek(now - day.todaySunset());
+	} else if (now < day.todaySunrise()) {
+		_daytime = false;
+		_date = day.before();
+		_boundary = day.yesterdaySunset();
+		_length = 86400 - day.yesterdaySunset() + day.todaySunrise();
+		seek(86400 - day.yesterdaySunset() + now);
+	} else {
+		_daytime = true;
+		_date = day.before();
+		_boundary = day.todaySunrise();
+		_length = day.todaySunset() - day.todaySunrise();
+		seek(now - day.todaySunrise());
+	}
+}
+
+// position within the segment from the seconds elapsed since its start
+void HebrewClock::seek(uint32_t elapsed) {
+	_elapsed = elapsed;
+	uint32_t total = elapsed * 12960 / _length;
+	_remainder = elapsed * 12960 % _length;
+	_hour = total / 1080 + (_daytime ? 12 : 0);
+	_chalakim = total % 1080;
+}
+
+// moves to the segment after the current one
+void HebrewClock::next() {
+	uint32_t end = (_boundary + _length) % 86400;
+	if (_daytime) {
+		// sunset: the night runs to the next sunrise
+		_sunriseDate = _sunriseDate + DaySpan(1);
+		uint32_t sunrise = (_sun.sunrise(_sunriseDate).time() + HourSpan(2)).secondsSinceMidnight();
+		_length = sunrise + 86400 - end;
+		_date = _date.nextDay();
 	} else {
-		// sunrise to sunset
-		daylen = todaySunset.secondsSinceMidnight() - todaySunrise.secondsSinceMidnight();
-		secs = now.secondsSinceMidnight() - todaySunrise.secondsSinceMidnight();;
-		hour = (double)secs / daylen * 12;
-		_hour = 12 + int(hour);
+		// sunrise: the day runs to sunset
+		uint32_t sunset = (_sun.sunset(_sunriseDate).time() + HourSpan(2)).secondsSinceMidnight();
+		_length = sunset - end;
 	}
-	_parts = hour - int(hour);
+	_boundary = end;
+	_daytime = !_daytime;
+}
+
+void HebrewClock::tick(uint16_t seconds) {
+	_elapsed += seconds;
+	if (_elapsed >= _length) {
+		uint32_t elapsed = _elapsed;
+		do {
+			elapsed -= _length;
+			next();
+		} while (elapsed >= _length);
+		seek(elapsed);
+		return;
 	}
+	_remainder += (uint32_t)12960 * seconds;
+	while (_remainder >= _length) {
+		_remainder -= _length;
+		if (++_chalakim == 1080) {
+			_chalakim = 0;
+			_hour++;
+		}
+	}
+}
@@ -9,10 +9,75 @@ class HebrewDateTime {
 		inline uint8_t hour() { return _hour; };
 		inline float parts() { return _parts; };
 		HebrewDateTime();
+		HebrewDateTime(HebrewDate date, uint8_t hour, float parts);
 		HebrewDateTime(DateTime datetime, ObserverLocation location);
 	private:
 		HebrewDate _date;
 		uint8_t _hour;
 		float _parts;
 };
+
+// sunset of the previous day, sunrise and sunset of the day and sunrise of the next day
+// at one location, as seconds since midnight, with the hebrew date before and after
+// sunset. a clock keeps one of these and calls at() every tick; update() recomputes it
+// only when the date changes, and moving to the next day reuses half the events.
+// datetime() and hours() go the other way, from a seasonal hour of the hebrew day
+// before() to the civil time it starts at, in the same time zone as at().
+class HebrewDay {
+	public:
+		HebrewDay(ObserverLocation location);
+		void update(Date date);
+		HebrewDateTime at(Time now);
+		HebrewDateTime at(DateTime datetime);
+		DateTime datetime(uint8_t hour, float parts=0);
+		void hours(DateTime * starts);
+		inline Date date() { return _date; };
+		inline HebrewDate before() { return _before; };
+		inline HebrewDate after() { return _after; };
+		inline uint32_t yesterdaySunset() { return _yesterdaySunset; };
+		inline uint32_t todaySunrise() { return _todaySunrise; };
+		inline uint32_t todaySunset() { return _todaySunset; };
+		inline uint32_t tomorrowSunrise() { return _tomorrowSunrise; };
+	private:
+		Sun _sun;
+		Date _date;
+		int32_t _days;
+		bool _valid;
+		uint32_t _yesterdaySunset;
+		uint32_t _todaySunrise;
+		uint32_t _todaySunset;
+		uint32_t _tomorrowSunrise;
+		HebrewDate _before;
+		HebrewDate _after;
+		DateTime civil(int32_t seconds);
+};
+
+// a running seasonal hour clock. start() syncs it to a civil time, after which tick()
+// advances it by elapsed seconds using integer additions only. the part of the hour is
+// counted in chalakim, 1080 to the hour, where HebrewDateTime::parts() is a fraction.
+// a sunrise or sunset computes the one boundary that follows it, so a clock ticking
+// every second calls Sun twice a day.
+class HebrewClock {
+	public:
+		HebrewClock(ObserverLocation location);
+		void start(DateTime datetime);
+		void tick(uint16_t seconds=1);
+		inline HebrewDate date() { return _date; };
+		inline uint8_t hour() { return _hour; };
+		inline uint16_t chalakim() { return _chalakim; };
+		inline uint32_t secondsToBoundary() { return _length - _elapsed; };
+	private:
+		Sun _sun;
+		HebrewDate _date;
+		Date _sunriseDate; // date of the sunrise ending the night, or of the day in progress
+		bool _daytime;
+		uint32_t _boundary; // seconds since midnight of the boundary starting the segment
+		uint32_t _length;
+		uint32_t _elapsed;
+		uint32_t _remainder;
+		uint8_t _hour;
+		uint16_t _chalakim;
+		void seek(uint32_t elapsed);
+		void next();
+};
 #endif
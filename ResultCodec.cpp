@@ -0,0 +1,217 @@
+#include "ResultCodec.h"
+#include <string.h>
+
+static void put16(uint8_t * p, uint16_t v) {
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+static void put32(uint8_t * p, uint32_t v) {
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static uint16_t get16(const uint8_t * p) {
+	return (uint16_t)p[0] | (uint16_t)p[1] << 8;
+}
+
+static uint32_t get32(const uint8_t * p) {
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void putFloat(uint8_t * p, float value) {
+	uint32_t v;
+	memcpy(&v, &value, 4);
+	put32(p, v);
+}
+
+static float getFloat(const uint8_t * p) {
+	uint32_t v = get32(p);
+	float f;
+	memcpy(&f, &v, 4);
+	return f;
+}
+
+// IEEE double bits to float where double is not 64 bit (AVR). the mantissa is
+// truncated; values out of the float range become 0 or infinity.
+static float narrow(uint64_t v) {
+	uint32_t sign = (uint32_t)(v >> 63) << 31;
+	int16_t exponent = (int16_t)((v >> 52) & 0x7FF) - 1023 + 127;
+	uint32_t mantissa = (uint32_t)(v >> 29) & 0x7FFFFF;
+	uint32_t bits;
+	if (((v >> 52) & 0x7FF) == 0x7FF)
+		bits = sign | 0x7F800000 | (mantissa | ((v & 0xFFFFFFFFFFFFFull) != 0));
+	else if (exponent >= 255)
+		bits = sign | 0x7F800000;
+	else if (exponent <= 0)
+		bits = sign;
+	else
+		bits = sign | (uint32_t)exponent << 23 | mantissa;
+	float f;
+	memcpy(&f, &bits, 4);
+	return f;
+}
+
+static void putReal(uint8_t * p, Real value) {
+	if (sizeof(Real) == 4) {
+		putFloat(p, value);
+		return;
+	}
+	uint64_t v = 0;
+	memcpy(&v, &value, sizeof(Real));
+	put32(p, (uint32_t)v);
+	put32(p + 4, (uint32_t)(v >> 32));
+}
+
+static Real getReal(const uint8_t * p, uint8_t size) {
+	if (size == 4)
+		return getFloat(p);
+	uint64_t v = (uint64_t)get32(p) | (uint64_t)get32(p + 4) << 32;
+	if (sizeof(double) != 8)
+		return narrow(v);
+	double d;
+	memcpy(&d, &v, sizeof(double));
+	return (Real)d;
+}
+
+static void putHebrewDate(uint8_t * p, HebrewDate date) {
+	put16(p, date.year());
+	p[2] = date.month();
+	p[3] = date.day();
+}
+
+static HebrewDate getHebrewDate(const uint8_t * p) {
+	return HebrewDate(get16(p), p[2], p[3]);
+}
+
+uint8_t ResultCodec::recordSize(CodecType type, uint8_t realSize) {
+	switch (type) {
+		case CODEC_HEBREW_DATE: return 4;
+		case CODEC_HEBREW_DATE_TIME: return 9;
+		case CODEC_SUN_POSITION: return 2 * realSize;
+		default: return 3 * realSize;
+	}
+}
+
+uint32_t ResultCodec::size(CodecType type, uint32_t count) {
+	return CODEC_HEADER_SIZE + count * recordSize(type, sizeof(Real));
+}
+
+uint8_t * ResultCodec::header(uint8_t * out, CodecType type, uint32_t count) {
+	put32(out, CODEC_MAGIC);
+	put16(out + 4, CODEC_VERSION);
+	out[6] = type;
+	out[7] = sizeof(Real);
+	put32(out + 8, count);
+	return out + CODEC_HEADER_SIZE;
+}
+
+// number of records in a block of the given type, or 0 when the block is not one
+uint32_t ResultCodec::count(const uint8_t * in, uint32_t length, CodecType type) {
+	if (length < CODEC_HEADER_SIZE || get32(in) != CODEC_MAGIC || get16(in + 4) != CODEC_VERSION ||
+			in[6] != type || (in[7] != 4 && in[7] != 8))
+		return 0;
+	uint32_t count = get32(in + 8);
+	if ((length - CODEC_HEADER_SIZE) / recordSize(type, in[7]) < count)
+		return 0;
+	return count;
+}
+
+// the encoders write size(type, count) bytes and return that size
+
+uint32_t ResultCodec::encode(const HebrewDate * values, uint32_t count, uint8_t * out) {
+	uint8_t * p = header(out, CODEC_HEBREW_DATE, count);
+	for (uint32_t i = 0; i < count; i++, p += 4)
+		putHebrewDate(p, values[i]);
+	return p - out;
+}
+
+uint32_t ResultCodec::encode(HebrewDateTime * values, uint32_t count, uint8_t * out) {
+	uint8_t * p = header(out, CODEC_HEBREW_DATE_TIME, count);
+	for (uint32_t i = 0; i < count; i++, p += 9) {
+		putHebrewDate(p, values[i].date());
+		p[4] = values[i].hour();
+		putFloat(p + 5, values[i].parts());
+	}
+	return p - out;
+}
+
+uint32_t ResultCodec::encode(const SunPosition * values, uint32_t count, uint8_t * out) {
+	uint8_t * p = header(out, CODEC_SUN_POSITION, count);
+	for (uint32_t i = 0; i < count; i++, p += 2 * sizeof(Real)) {
+		putReal(p, values[i].azimuth);
+		putReal(p + sizeof(Real), values[i].altitude);
+	}
+	return p - out;
+}
+
+uint32_t ResultCodec::encode(const MoonIllumination * values, uint32_t count, uint8_t * out) {
+	uint8_t * p = header(out, CODEC_MOON_ILLUMINATION, count);
+	for (uint32_t i = 0; i < count; i++, p += 3 * sizeof(Real)) {
+		putReal(p, values[i].fraction);
+		putReal(p + sizeof(Real), values[i].phase);
+		putReal(p + 2 * sizeof(Real), values[i].angle);
+	}
+	return p - out;
+}
+
+// record i of a checked block
+void ResultCodec::read(const uint8_t * in, uint32_t i, HebrewDate * value) {
+	*value = getHebrewDate(in + CODEC_HEADER_SIZE + i * 4);
+}
+
+void ResultCodec::read(const uint8_t * in, uint32_t i, HebrewDateTime * value) {
+	const uint8_t * p = in + CODEC_HEADER_SIZE + i * 9;
+	*value = HebrewDateTime(getHebrewDate(p), p[4], getFloat(p + 5));
+}
+
+void ResultCodec::read(const uint8_t * in, uint32_t i, SunPosition * value) {
+	uint8_t size = in[7];
+	const uint8_t * p = in + CODEC_HEADER_SIZE + i * 2 * size;
+	value->azimuth = getReal(p, size);
+	value->altitude = getReal(p + size, size);
+}
+
+void ResultCodec::read(const uint8_t * in, uint32_t i, MoonIllumination * value) {
+	uint8_t size = in[7];
+	const uint8_t * p = in + CODEC_HEADER_SIZE + i * 3 * size;
+	value->fraction = getReal(p, size);
+	value->phase = getReal(p + size, size);
+	value->angle = getReal(p + 2 * size, size);
+}
+
+// the decoders fill up to max values and return how many, 0 for a block of another type
+
+uint32_t ResultCodec::decode(const uint8_t * in, uint32_t length, HebrewDate * values, uint32_t max) {
+	uint32_t n = count(in, length, CODEC_HEBREW_DATE);
+	n = n < max ? n : max;
+	for (uint32_t i = 0; i < n; i++)
+		read(in, i, &values[i]);
+	return n;
+}
+
+uint32_t ResultCodec::decode(const uint8_t * in, uint32_t length, HebrewDateTime * values, uint32_t max) {
+	uint32_t n = count(in, length, CODEC_HEBREW_DATE_TIME);
+	n = n < max ? n : max;
+	for (uint32_t i = 0; i < n; i++)
+		read(in, i, &values[i]);
+	return n;
+}
+
+uint32_t ResultCodec::decode(const uint8_t * in, uint32_t length, SunPosition * values, uint32_t max) {
+	uint32_t n = count(in, length, CODEC_SUN_POSITION);
+	n = n < max ? n : max;
+	for (uint32_t i = 0; i < n; i++)
+		read(in, i, &values[i]);
+	return n;
+}
+
+uint32_t ResultCodec::decode(const uint8_t * in, uint32_t length, MoonIllumination * values, uint32_t max) {
+	uint32_t n = count(in, length, CODEC_MOON_ILLUMINATION);
+	n = n < max ? n : max;
+	for (uint32_t i = 0; i < n; i++)
+		read(in, i, &values[i]);
+	return n;
+}
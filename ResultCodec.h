@@ -0,0 +1,50 @@
+#ifndef ResultCodec_h
+#define ResultCodec_h
+#include "Sun.h"
+#include "HebrewDate.h"
+#include "HebrewDateTime.h"
+#include <stdint.h>
+
+#define CODEC_MAGIC 0x544C5352 // "RSLT"
+#define CODEC_VERSION 1
+#define CODEC_HEADER_SIZE 12
+
+enum CodecType {
+	CODEC_HEBREW_DATE,
+	CODEC_HEBREW_DATE_TIME,
+	CODEC_SUN_POSITION,
+	CODEC_MOON_ILLUMINATION
+};
+
+// a versioned, byte order independent encoding of result arrays. a block starts with a
+// header of magic (4 bytes), version (2), type (1), real size (1) and count (4), all
+// little endian, followed by fixed size little endian records:
+//   HebrewDate        year (2), month (1), day (1)
+//   HebrewDateTime    HebrewDate (4), hour (1), parts (4, IEEE float)
+//   SunPosition       azimuth, altitude (real size each)
+//   MoonIllumination  fraction, phase, angle (real size each)
+// Real values are written at the width of Real, 4 (IEEE float) or 8 (IEEE double), so
+// encoding loses nothing; a block of the other width still decodes, converted to Real.
+// a block can be decoded as a whole, or read record by record where it lies, e.g. in a
+// mapped file, once count() has checked it.
+class ResultCodec {
+	public:
+		static uint32_t size(CodecType type, uint32_t count);
+		static uint32_t count(const uint8_t * in, uint32_t length, CodecType type);
+		static uint32_t encode(const HebrewDate * values, uint32_t count, uint8_t * out);
+		static uint32_t encode(HebrewDateTime * values, uint32_t count, uint8_t * out);
+		static uint32_t encode(const SunPosition * values, uint32_t count, uint8_t * out);
+		static uint32_t encode(const MoonIllumination * values, uint32_t count, uint8_t * out);
+		static uint32_t decode(const uint8_t * in, uint32_t length, HebrewDate * values, uint32_t max);
+		static uint32_t decode(const uint8_t * in, uint32_t length, HebrewDateTime * values, uint32_t max);
+		static uint32_t decode(const uint8_t * in, uint32_t length, SunPosition * values, uint32_t max);
+		static uint32_t decode(const uint8_t * in, uint32_t length, MoonIllumination * values, uint32_t max);
+		static void read(const uint8_t * in, uint32_t i, HebrewDate * value);
+		static void read(const uint8_t * in, uint32_t i, HebrewDateTime * value);
+		static void read(const uint8_t * in, uint32_t i, SunPosition * value);
+		static void read(const uint8_t * in, uint32_t i, MoonIllumination * value);
+	private:
+		static uint8_t recordSize(CodecType type, uint8_t realSize);
+		static uint8_t * header(uint8_t * out, CodecType type, uint32_t count);
+};
+#endif
@@ -3,60 +3,147 @@
 #include "DateTime.h"
 #include <time.h>
 
+// scalar type of the astronomy code. double by default; define SUN_SINGLE_PRECISION
+// on targets without a double precision FPU, where float is enough for minute
+// resolution. day counts and julian dates stay double either way (on AVR double is
+// float anyway), so only the angles lose precision.
+#ifdef SUN_SINGLE_PRECISION
+typedef float Real;
+#else
+typedef double Real;
+#endif
+
+class ChebyshevEphemeris;
+
 typedef struct {
-	double latitude;
-	double longitude;
+	Real latitude;
+	Real longitude;
 } ObserverLocation;
 
 typedef struct {
-	double azimuth;
-	double altitude;
+	Real azimuth;
+	Real altitude;
 } SunPosition;
 
 typedef struct {
-	double declination;
-	double rightAscension;
+	Real declination;
+	Real rightAscension;
 } SunCoordinates;
 
+typedef struct {
+	Real declination;
+	Real rightAscension;
+	Real sinDeclination;
+	Real cosDeclination;
+	Real transit; // equation of time correction of the solar transit, in days
+} SolarEphemeris;
+
+// output arrays of Sun::track, one entry per sample. arrays left NULL are not computed.
+typedef struct {
+	Real * azimuth;
+	Real * altitude;
+} SunTrack;
+
+// per-day solar ephemeris over a range of days since J2000, stored in a caller
+// supplied array. entries are plain scalars, so a built table can be written to a
+// file and later mapped back in on the same platform instead of being rebuilt.
+class SolarEphemerisTable {
+	public:
+		SolarEphemerisTable(SolarEphemeris * entries, int32_t firstDay, uint32_t days);
+		void build();
+		bool lookup(double d, SolarEphemeris * result);
+		inline int32_t firstDay() { return _firstDay; };
+		inline uint32_t days() { return _days; };
+	private:
+		SolarEphemeris * _entries;
+		int32_t _firstDay;
+		uint32_t _days;
+};
+
 class Sun {
 	public:
+		static SolarEphemeris ephemeris(double d);
+		static void useEphemeris(SolarEphemerisTable * table);
+		static bool useChebyshevEphemeris(ChebyshevEphemeris * ephemeris);
 		Sun(ObserverLocation observer);
+		inline ObserverLocation observer() { return _observer; };
 		SunCoordinates coordinates(DateTime datetime);
 		SunPosition position(DateTime datetime);
+		Real altitudeAt(time_t t);
+		void track(DateTime start, uint32_t step, uint32_t count, SunTrack out, bool refraction = false);
 		DateTime sunrise(Date date);
 		DateTime sunset(Date date);
+		void times(Date first, uint16_t days, time_t * sunrises, time_t * sunsets);
+		static void times(Date date, uint32_t count, const Real * latitudes, const Real * longitudes,
+				time_t * sunrises, time_t * sunsets);
 	private:
+		static SolarEphemerisTable * _ephemeris;
+		static ChebyshevEphemeris * _chebyshev;
+		static SunCoordinates coordinatesAt(double d);
+		void transit(Date date, double * noon, Real * halfDay);
 		ObserverLocation _observer;
+		Real _sinPhi;
+		Real _cosPhi;
+#ifdef SUN_FIXED_POINT
+		int32_t _fixedLatitude;
+		int32_t _fixedLongitude;
+#endif
 };
 
 typedef struct {
-	double rightAscension;
-	double declination;
-	double distance;
+	Real rightAscension;
+	Real declination;
+	Real distance;
 } MoonCoordinates;
 
 typedef struct {
-	double azimuth;
-	double altitude;
-	double distance;
-	double parallacticAngle;
+	Real azimuth;
+	Real altitude;
+	Real distance;
+	Real parallacticAngle;
 } MoonPosition;
 
 typedef struct {
-	double fraction;
-	double phase;
-	double angle;
+	Real fraction;
+	Real phase;
+	Real angle;
 } MoonIllumination;
 
+// output arrays of Moon::illuminations, one entry per sample. arrays left NULL are
+// not computed.
+typedef struct {
+	Real * fraction;
+	Real * phase;
+	Real * angle;
+	Real * altitude;
+	Real * azimuth;
+} MoonIlluminationSeries;
+
+typedef struct {
+	DateTime rise;
+	DateTime set;
+	bool rises;
+	bool sets;
+	bool alwaysUp;
+	bool alwaysDown;
+} MoonEvents;
+
 class Moon {
 	public:
+		static MoonCoordinates seriesCoordinates(double d);
+		static bool useChebyshevEphemeris(ChebyshevEphemeris * ephemeris);
 		Moon(ObserverLocation observer);
 		MoonCoordinates coordinates(DateTime datetime);
 		MoonPosition position(DateTime datetime);
+		Real altitudeAt(time_t t);
 		MoonIllumination illumination(DateTime datetime);
+		void illuminations(DateTime start, uint32_t step, uint16_t count, MoonIlluminationSeries series);
 		DateTime moonrise(DateTime datetime);
 		DateTime moonset(DateTime datetime);
+		MoonEvents events(DateTime datetime);
 	private:
+		static ChebyshevEphemeris * _chebyshev;
+		static MoonCoordinates coordinatesAt(double d);
 		ObserverLocation _observer;
 };
 #endif
@@ -0,0 +1,125 @@
+#include "Timetable.h"
+#include <stdio.h>
+#include <string.h>
+
+// shabbat or a yom tov on which candles are lit and havdalah is said
+bool Timetable::isRestDay(HebrewDate date, bool diaspora) {
+	if (date.dayOfWeek() == 7)
+		return true;
+	switch (date.holiday(diaspora)) {
+		case PESACH:
+		case PESACH_DIASPORA:
+		case PESACH_7:
+		case PESACH_7_DIASPORA:
+		case SHAVUOT:
+		case SHAVUOT_DIASPORA:
+		case ROSH_HASHANA:
+		case ROSH_HASHANA_2:
+		case KIPPUR:
+		case SUKKOT:
+		case SUKKOT_DIASPORA:
+		case SHEMINI_ATZERET_SIMCHAT_TORAH:
+		case SHEMINI_ATZERET:
+		case SIMCHAT_TORAH:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// the eves of the given civil year, in date order. eves must hold TIMETABLE_MAX_EVES
+// entries. the hebrew date is advanced with nextDay, so the calendar is only converted
+// once per year.
+uint16_t Timetable::eves(uint16_t year, bool diaspora, TimetableEve * eves) {
+	Date first = Date(year, 1, 1);
+	int32_t days = first.daysSinceEpoch();
+	uint16_t length = Date::isLeapYear(year) ? 366 : 365;
+	HebrewDate today = HebrewDate(days);
+	bool rest = isRestDay(today, diaspora);
+	uint16_t count = 0;
+	for (uint16_t i = 0; i < length && count < TIMETABLE_MAX_EVES; i++) {
+		HebrewDate tomorrow = today.nextDay();
+		bool restTomorrow = isRestDay(tomorrow, diaspora);
+		if (rest != restTomorrow || (rest && restTomorrow)) {
+			TimetableEve * e = &eves[count++];
+			e->date = Date(days + i);
+			if (restTomorrow) {
+				HebrewHoliday h = tomorrow.dayOfWeek() == 7 ? (HebrewHoliday)0 : tomorrow.holiday(diaspora);
+				e->kind = CANDLE_LIGHTING;
+				e->holiday = h;
+				// lit after nightfall from an existing flame, except before shabbat
+				e->secondDay = rest && tomorrow.dayOfWeek() != 7;
+			} else {
+				e->kind = HAVDALAH;
+				e->holiday = today.dayOfWeek() == 7 ? (HebrewHoliday)0 : today.holiday(diaspora);
+				e->secondDay = false;
+			}
+		}
+		today = tomorrow;
+		rest = restTomorrow;
+	}
+	return count;
+}
+
+Timetable::Timetable(uint32_t count, const Real * latitudes, const Real * longitudes,
+		time_t * sunrises, time_t * sunsets) {
+	_count = count;
+	_latitudes = latitudes;
+	_longitudes = longitudes;
+	_sunrises = sunrises;
+	_sunsets = sunsets;
+	_used = 0;
+}
+
+void Timetable::flush() {
+	if (_used > 0)
+		_sink(_context, _buffer, _used);
+	_used = 0;
+}
+
+void Timetable::write(const void * data, uint32_t length) {
+	if (_used + length > TIMETABLE_BUFFER)
+		flush();
+	memcpy(_buffer + _used, data, length);
+	_used += length;
+}
+
+// rows are ordered by date and then by location. CSV rows read
+// location,YYYY-MM-DD,candle|havdalah,holiday,unix time
+void Timetable::generate(uint16_t firstYear, uint16_t lastYear, TimetableRules rules,
+		TimetableFormat format, TimetableSink sink, void * context) {
+	_sink = sink;
+	_context = context;
+	_used = 0;
+	TimetableEve eves[TIMETABLE_MAX_EVES];
+	for (uint16_t year = firstYear; year <= lastYear; year++) {
+		uint16_t count = Timetable::eves(year, rules.diaspora, eves);
+		for (uint16_t e = 0; e < count; e++) {
+			TimetableEve * eve = &eves[e];
+			Sun::times(eve->date, _count, _latitudes, _longitudes, _sunrises, _sunsets);
+			int32_t offset = eve->kind == CANDLE_LIGHTING && !eve->secondDay ?
+					-60 * (int32_t)rules.candleLighting : 60 * (int32_t)rules.havdalah;
+			int32_t day = eve->date.daysSinceEpoch();
+			char line[64];
+			for (uint32_t i = 0; i < _count; i++) {
+				time_t t = _sunsets[i] + offset;
+				if (format == TIMETABLE_BINARY) {
+					TimetableRow row;
+					row.location = i;
+					row.day = day;
+					row.time = (int32_t)t;
+					row.kind = eve->kind;
+					row.holiday = eve->holiday;
+					row.reserved = 0;
+					write(&row, sizeof(row));
+				} else {
+					int length = snprintf(line, sizeof(line), "%lu,%04u-%02u-%02u,%s,%u,%ld\n",
+							(unsigned long)i, eve->date.year(), eve->date.month(), eve->date.day(),
+							eve->kind == CANDLE_LIGHTING ? "candle" : "havdalah", eve->holiday, (long)t);
+					write(line, length);
+				}
+			}
+		}
+	}
+	flush();
+}
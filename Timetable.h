@@ -0,0 +1,78 @@
+#ifndef Timetable_h
+#define Timetable_h
+#include "Sun.h"
+#include "HebrewDate.h"
+#include <stdint.h>
+
+#ifndef TIMETABLE_BUFFER
+#define TIMETABLE_BUFFER 4096
+#endif
+#define TIMETABLE_MAX_EVES 160 // rows per location in one civil year, with room to spare
+
+enum TimetableKind {
+	CANDLE_LIGHTING,
+	HAVDALAH
+};
+
+enum TimetableFormat {
+	TIMETABLE_CSV,
+	TIMETABLE_BINARY
+};
+
+// minutes before sunset for candle lighting and after sunset for havdalah. when a yom
+// tov follows another rest day candles are lit at the havdalah time.
+typedef struct {
+	uint8_t candleLighting;
+	uint8_t havdalah;
+	bool diaspora;
+} TimetableRules;
+
+// a day whose sunset starts or ends a shabbat or yom tov. holiday is the yom tov that
+// starts (candle lighting) or ends (havdalah), 0 for shabbat.
+typedef struct {
+	Date date;
+	uint8_t kind;
+	uint8_t holiday;
+	bool secondDay;
+} TimetableEve;
+
+// record of the binary format, in the byte order of the machine that wrote it
+typedef struct {
+	uint32_t location;
+	int32_t day; // Date::daysSinceEpoch
+	int32_t time; // unix time
+	uint8_t kind;
+	uint8_t holiday;
+	uint16_t reserved;
+} TimetableRow;
+
+typedef void (*TimetableSink)(void * context, const uint8_t * data, uint32_t length);
+
+// candle lighting and havdalah times for many locations over a range of civil years.
+// the eves are found once per year from the hebrew calendar, the sunsets of each eve
+// are computed for all locations with the multi-location Sun::times (split across
+// threads when built with OpenMP), and the rows are written through a fixed buffer
+// that is handed to the sink whenever it fills up. sunrises and sunsets are work
+// arrays of count entries supplied by the caller.
+class Timetable {
+	public:
+		static uint16_t eves(uint16_t year, bool diaspora, TimetableEve * eves);
+		Timetable(uint32_t count, const Real * latitudes, const Real * longitudes,
+				time_t * sunrises, time_t * sunsets);
+		void generate(uint16_t firstYear, uint16_t lastYear, TimetableRules rules,
+				TimetableFormat format, TimetableSink sink, void * context);
+	private:
+		static bool isRestDay(HebrewDate date, bool diaspora);
+		uint32_t _count;
+		const Real * _latitudes;
+		const Real * _longitudes;
+		time_t * _sunrises;
+		time_t * _sunsets;
+		uint8_t _buffer[TIMETABLE_BUFFER];
+		uint32_t _used;
+		TimetableSink _sink;
+		void * _context;
+		void write(const void * data, uint32_t length);
+		void flush();
+};
+#endif
@@ -0,0 +1,103 @@
+#include "Workdays.h"
+
+static uint8_t bitCount(uint32_t x) {
+	x = x - ((x >> 1) & 0x55555555);
+	x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+	return (uint8_t)((((x + (x >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+}
+
+uint32_t WorkdayIndex::blocks(uint32_t days) {
+	return (days + 31) / 32;
+}
+
+WorkdayIndex::WorkdayIndex(WorkdayBlock * blocks, int32_t firstDay, uint32_t days) {
+	_blocks = blocks;
+	_firstDay = firstDay;
+	_days = days;
+}
+
+// days past the end of the range are marked as rest days so they are never counted
+void WorkdayIndex::build(uint64_t restHolidays, bool diaspora) {
+	HebrewDate date = HebrewDate(_firstDay);
+	uint8_t dayOfWeek = date.dayOfWeek();
+	uint32_t count = 0;
+	for (uint32_t b = 0; b < blocks(_days); b++) {
+		uint32_t rest = 0;
+		for (uint8_t i = 0; i < 32; i++) {
+			if (b * 32 + i >= _days) {
+				rest |= (uint32_t)1 << i;
+				continue;
+			}
+			if (dayOfWeek == 7 || (restHolidays & HOLIDAY_BIT(date.holiday(diaspora))))
+				rest |= (uint32_t)1 << i;
+			date = date.nextDay();
+			dayOfWeek = dayOfWeek == 7 ? 1 : dayOfWeek + 1;
+		}
+		_blocks[b].rest = rest;
+		_blocks[b].before = count;
+		count += 32 - bitCount(rest);
+	}
+}
+
+// working days from the start of the range to day i of it, excluding day i. i may be
+// one past the end of the range.
+uint32_t WorkdayIndex::before(uint32_t i) {
+	if (i / 32 == blocks(_days)) {
+		if (i == 0)
+			return 0;
+		WorkdayBlock * last = &_blocks[i / 32 - 1];
+		return last->before + 32 - bitCount(last->rest);
+	}
+	WorkdayBlock * block = &_blocks[i / 32];
+	uint32_t mask = ((uint32_t)1 << (i % 32)) - 1;
+	return block->before + (i % 32) - bitCount(block->rest & mask);
+}
+
+bool WorkdayIndex::isWorkday(int32_t day) {
+	uint32_t i = (uint32_t)(day - _firstDay);
+	return i < _days && !(_blocks[i / 32].rest & ((uint32_t)1 << (i % 32)));
+}
+
+// working days from from to to, counting from but not to. negative when to is before
+// from. returns false when a day is outside the range (to may be one past its end).
+bool WorkdayIndex::between(int32_t from, int32_t to, int32_t * count) {
+	uint32_t a = (uint32_t)(from - _firstDay);
+	uint32_t b = (uint32_t)(to - _firstDay);
+	if (a > _days || b > _days)
+		return false;
+	*count = (int32_t)before(b) - (int32_t)before(a);
+	return true;
+}
+
+// the working day reached by counting the given number of working days after day,
+// or day itself for 0. returns false when the result is past the end of the range.
+bool WorkdayIndex::add(int32_t day, uint32_t workdays, int32_t * result) {
+	uint32_t i = (uint32_t)(day - _firstDay);
+	if (i >= _days)
+		return false;
+	if (workdays == 0) {
+		*result = day;
+		return true;
+	}
+	// index among the working days of the one we are looking for
+	uint32_t k = before(i) + (isWorkday(day) ? 1 : 0) + workdays - 1;
+	uint32_t low = 0, high = blocks(_days);
+	while (high - low > 1) {
+		uint32_t middle = (low + high) / 2;
+		if (_blocks[middle].before <= k)
+			low = middle;
+		else
+			high = middle;
+	}
+	uint32_t skip = k - _blocks[low].before;
+	uint32_t rest = _blocks[low].rest;
+	for (uint8_t bit = 0; bit < 32; bit++) {
+		if (rest & ((uint32_t)1 << bit))
+			continue;
+		if (skip-- == 0) {
+			*result = _firstDay + (int32_t)(low * 32 + bit);
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,39 @@
+#ifndef Workdays_h
+#define Workdays_h
+#include "HebrewDate.h"
+#include <stdint.h>
+
+#define HOLIDAY_BIT(h) ((uint64_t)1 << (h))
+// the holidays on which work is forbidden; the diaspora days only occur with diaspora
+#define WORKDAYS_YOM_TOV (HOLIDAY_BIT(PESACH) | HOLIDAY_BIT(PESACH_DIASPORA) | \
+		HOLIDAY_BIT(PESACH_7) | HOLIDAY_BIT(PESACH_7_DIASPORA) | HOLIDAY_BIT(SHAVUOT) | \
+		HOLIDAY_BIT(SHAVUOT_DIASPORA) | HOLIDAY_BIT(ROSH_HASHANA) | HOLIDAY_BIT(ROSH_HASHANA_2) | \
+		HOLIDAY_BIT(KIPPUR) | HOLIDAY_BIT(SUKKOT) | HOLIDAY_BIT(SUKKOT_DIASPORA) | \
+		HOLIDAY_BIT(SHEMINI_ATZERET_SIMCHAT_TORAH) | HOLIDAY_BIT(SHEMINI_ATZERET) | \
+		HOLIDAY_BIT(SIMCHAT_TORAH))
+
+// 32 consecutive days: a bit set for each rest day, and the working days before them
+typedef struct {
+	uint32_t rest;
+	uint32_t before;
+} WorkdayBlock;
+
+// working days over a range of days since epoch, excluding shabbat and the holidays
+// of a mask of HOLIDAY_BIT values. counting the working days between two days takes
+// two block reads; adding working days to a day is a binary search over the blocks.
+// the caller supplies blocks(days) entries, which can be saved and loaded as they are.
+class WorkdayIndex {
+	public:
+		static uint32_t blocks(uint32_t days);
+		WorkdayIndex(WorkdayBlock * blocks, int32_t firstDay, uint32_t days);
+		void build(uint64_t restHolidays=WORKDAYS_YOM_TOV, bool diaspora=false);
+		bool isWorkday(int32_t day);
+		bool between(int32_t from, int32_t to, int32_t * count);
+		bool add(int32_t day, uint32_t workdays, int32_t * result);
+	private:
+		WorkdayBlock * _blocks;
+		int32_t _firstDay;
+		uint32_t _days;
+		uint32_t before(uint32_t i);
+};
+#endif
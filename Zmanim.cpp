@@ -0,0 +1,74 @@
+#include "Zmanim.h"
+
+#define ZMANIM_BLOCK 64
+
+// bytes of a table, or 0 when it would not fit in 32 bits
+uint32_t ZmanimTable::size(uint32_t locations, uint32_t days) {
+	uint64_t size = sizeof(ZmanimHeader) + (uint64_t)locations * sizeof(ZmanimLocation) +
+			(uint64_t)ZMANIM_COLUMNS * locations * days * sizeof(int32_t);
+	return size > 0xFFFFFFFF ? 0 : (uint32_t)size;
+}
+
+// buffer must hold size(count, days) bytes, which must not be 0. the days of each
+// location are computed with the batch Sun::times.
+void ZmanimTable::build(void * buffer, const ObserverLocation * locations, uint32_t count,
+		Date first, uint32_t days) {
+	ZmanimHeader * header = (ZmanimHeader *)buffer;
+	header->magic = ZMANIM_MAGIC;
+	header->version = ZMANIM_VERSION;
+	header->columns = ZMANIM_COLUMNS;
+	header->firstDay = first.daysSinceEpoch();
+	header->days = days;
+	header->locations = count;
+	ZmanimLocation * index = (ZmanimLocation *)(header + 1);
+	int32_t * sunrises = (int32_t *)(index + count);
+	int32_t * sunsets = sunrises + count * days;
+	time_t midnight = DateTime(first, Time(0, 0, 0)).unixtime();
+	time_t rises[ZMANIM_BLOCK], sets[ZMANIM_BLOCK];
+	for (uint32_t l = 0; l < count; l++) {
+		index[l].latitude = locations[l].latitude;
+		index[l].longitude = locations[l].longitude;
+		Sun sun = Sun(locations[l]);
+		for (uint32_t start = 0; start < days; start += ZMANIM_BLOCK) {
+			uint16_t n = days - start < ZMANIM_BLOCK ? days - start : ZMANIM_BLOCK;
+			sun.times(Date(header->firstDay + (int32_t)start), n, rises, sets);
+			for (uint16_t i = 0; i < n; i++) {
+				time_t day = midnight + (time_t)86400 * (start + i);
+				sunrises[l * days + start + i] = (int32_t)(rises[i] - day);
+				sunsets[l * days + start + i] = (int32_t)(sets[i] - day);
+			}
+		}
+	}
+}
+
+ZmanimTable::ZmanimTable(const void * data) {
+	_header = (const ZmanimHeader *)data;
+	_locations = (const ZmanimLocation *)(_header + 1);
+	_values = (const int32_t *)(_locations + _header->locations);
+}
+
+bool ZmanimTable::valid() {
+	return _header->magic == ZMANIM_MAGIC && _header->version == ZMANIM_VERSION &&
+			_header->columns == ZMANIM_COLUMNS;
+}
+
+// index of the location in the table, or -1. the search is linear, so callers look a
+// location up once and keep the index.
+int32_t ZmanimTable::location(ObserverLocation observer) {
+	for (uint32_t l = 0; l < _header->locations; l++)
+		if (_locations[l].latitude == (float)observer.latitude && _locations[l].longitude == (float)observer.longitude)
+			return (int32_t)l;
+	return -1;
+}
+
+// the event on the given date as unix time, from the table when it holds the location
+// and the date, computed for the observer otherwise
+time_t ZmanimTable::time(ZmanimColumn column, int32_t location, ObserverLocation observer, Date date) {
+	int32_t i = date.daysSinceEpoch() - _header->firstDay;
+	if (location < 0 || (uint32_t)location >= _header->locations || i < 0 || (uint32_t)i >= _header->days) {
+		Sun sun = Sun(observer);
+		return (column == ZMANIM_SUNRISE ? sun.sunrise(date) : sun.sunset(date)).unixtime();
+	}
+	const int32_t * values = _values + ((uint32_t)column * _header->locations + location) * _header->days;
+	return DateTime(date, Time(0, 0, 0)).unixtime() + values[i];
+}
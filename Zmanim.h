@@ -0,0 +1,57 @@
+#ifndef Zmanim_h
+#define Zmanim_h
+#include "Sun.h"
+#include <stdint.h>
+
+#define ZMANIM_MAGIC 0x4E4D5A48 // "HZMN"
+#define ZMANIM_VERSION 1
+
+enum ZmanimColumn {
+	ZMANIM_SUNRISE,
+	ZMANIM_SUNSET,
+	ZMANIM_COLUMNS
+};
+
+// header of a zmanim table. it is followed by the locations, then by one column per
+// ZmanimColumn holding, for each location, one int32_t per day: the seconds from
+// 00:00 UTC of the day to the event. values are stored in the byte order of the
+// machine that built the table.
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t columns;
+	int32_t firstDay; // Date::daysSinceEpoch of the first day
+	uint32_t days;
+	uint32_t locations;
+} ZmanimHeader;
+
+typedef struct {
+	float latitude;
+	float longitude;
+} ZmanimLocation;
+
+// sunrise and sunset for a set of locations over a range of days, precomputed into a
+// single block that can be written to a file and later read or mapped back in. a
+// lookup is an index computation; locations or days the table does not cover are
+// computed with Sun instead.
+class ZmanimTable {
+	public:
+		static uint32_t size(uint32_t locations, uint32_t days);
+		static void build(void * buffer, const ObserverLocation * locations, uint32_t count,
+				Date first, uint32_t days);
+		ZmanimTable(const void * data);
+		bool valid();
+		int32_t location(ObserverLocation observer);
+		time_t time(ZmanimColumn column, int32_t location, ObserverLocation observer, Date date);
+		inline time_t sunrise(int32_t location, ObserverLocation observer, Date date) {
+			return time(ZMANIM_SUNRISE, location, observer, date);
+		};
+		inline time_t sunset(int32_t location, ObserverLocation observer, Date date) {
+			return time(ZMANIM_SUNSET, location, observer, date);
+		};
+	private:
+		const ZmanimHeader * _header;
+		const ZmanimLocation * _locations;
+		const int32_t * _values;
+};
+#endif
@@ -0,0 +1,22 @@
+#ifndef Bench_h
+#define Bench_h
+#include <stdint.h>
+#include <time.h>
+
+// timing helpers for the host programs in examples/. they are not part of the
+// library and are not meant for the Arduino targets.
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES 1
+inline uint64_t benchCycles() {
+	return __rdtsc();
+}
+#endif
+
+inline double benchSeconds() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+#endif
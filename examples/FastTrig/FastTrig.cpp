@@ -0,0 +1,162 @@
+// accuracy and speed of the FastTrig.h kernels against libm, and the error they add
+// to sunrise, sunset and the sun and moon positions. Sun.cpp is built once without and
+// once with SUN_FAST_TRIG; the first run writes the reference, the second compares:
+//   g++ -O2 -I. examples/FastTrig/FastTrig.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o exact
+//   g++ -O2 -I. -DSUN_FAST_TRIG examples/FastTrig/FastTrig.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o fast
+//   ./exact -w times.bin && ./fast times.bin
+// add -DSUN_SINGLE_PRECISION to both builds for the float figures.
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "Sun.h"
+#include "FastTrig.h"
+#include "examples/Bench.h"
+
+#define SAMPLES 4096
+#define ROUNDS 2000
+
+typedef struct {
+	time_t sunrise;
+	time_t sunset;
+	double sunAzimuth;
+	double sunAltitude;
+	double moonAzimuth;
+	double moonAltitude;
+} Reference;
+
+static const ObserverLocation cities[] = { { 31.778, 35.235 }, { 40.71, -74.01 }, { 51.5, -0.12 },
+		{ -33.9, 151.2 }, { 55.75, 37.62 } };
+
+static Real inputs[SAMPLES];
+static Real others[SAMPLES];
+volatile Real sink;
+
+// ns per call of expression e over the inputs x (and y)
+#define TIME(e) ({ \
+	double start = benchSeconds(); \
+	for (int r = 0; r < ROUNDS; r++) { \
+		Real sum = 0; \
+		for (int i = 0; i < SAMPLES; i++) { \
+			Real x = inputs[i], y = others[i]; \
+			(void)y; \
+			sum += e; \
+		} \
+		sink = sum; \
+	} \
+	(benchSeconds() - start) * 1e9 / ((double)ROUNDS * SAMPLES); })
+
+static void fill(Real low, Real high) {
+	for (int i = 0; i < SAMPLES; i++) {
+		inputs[i] = low + (high - low) * i / (SAMPLES - 1);
+		others[i] = (Real)cos(i * 0.37) * 2;
+	}
+}
+
+static void kernels() {
+	double e[6] = { 0 };
+	for (int i = 0; i <= 400000; i++) {
+		double x = -20 + 40.0 * i / 400000, u = -1 + 2.0 * i / 400000, t = -1.4 + 2.8 * i / 400000;
+		double a = 2 * M_PI * i / 400000;
+		e[0] = fmax(e[0], fabs(fastSin((Real)x) - sin((Real)x)));
+		e[1] = fmax(e[1], fabs(fastCos((Real)x) - cos((Real)x)));
+		e[2] = fmax(e[2], fabs(fastTan((Real)t) - tan((Real)t)));
+		e[3] = fmax(e[3], fabs(fastAsin((Real)u) - asin((Real)u)));
+		e[4] = fmax(e[4], fabs(fastAcos((Real)u) - acos((Real)u)));
+		Real y = (Real)(sin(a) * (1 + i % 7)), z = (Real)(cos(a) * (1 + i % 7));
+		e[5] = fmax(e[5], fabs(fastAtan2(y, z) - atan2(y, z)));
+	}
+	printf("largest error against libm\n");
+	printf("  sin, cos on [-20, 20]   %.1e %.1e\n", e[0], e[1]);
+	printf("  tan on [-1.4, 1.4]      %.1e\n", e[2]);
+	printf("  asin, acos on [-1, 1]   %.1e %.1e\n", e[3], e[4]);
+	printf("  atan2 around the circle %.1e\n", e[5]);
+
+	printf("ns per call, libm -> fast\n");
+	fill(-20, 20);
+	printf("  sin   %5.1f -> %5.1f\n", TIME(sin(x)), TIME(fastSin(x)));
+	printf("  cos   %5.1f -> %5.1f\n", TIME(cos(x)), TIME(fastCos(x)));
+	fill(-1.4, 1.4);
+	printf("  tan   %5.1f -> %5.1f\n", TIME(tan(x)), TIME(fastTan(x)));
+	printf("  atan2 %5.1f -> %5.1f\n", TIME(atan2(x, y)), TIME(fastAtan2(x, y)));
+	fill(-1, 1);
+	printf("  asin  %5.1f -> %5.1f\n", TIME(asin(x)), TIME(fastAsin(x)));
+	printf("  acos  %5.1f -> %5.1f\n", TIME(acos(x)), TIME(fastAcos(x)));
+}
+
+// sunrise, sunset and positions every 7 days of 2000-2100 in five cities
+static uint32_t grid(Reference * out) {
+	uint32_t n = 0;
+	time_t first = DateTime(Date(2000, 1, 1), Time(0, 0, 0)).unixtime();
+	time_t last = DateTime(Date(2100, 1, 1), Time(0, 0, 0)).unixtime();
+	for (uint8_t c = 0; c < 5; c++) {
+		Sun sun(cities[c]);
+		Moon moon(cities[c]);
+		for (time_t t = first; t < last; t += 7 * 86400, n++) {
+			Date date = DateTime(t).date();
+			DateTime noon(t + 12 * 3600);
+			out[n].sunrise = sun.sunrise(date).unixtime();
+			out[n].sunset = sun.sunset(date).unixtime();
+			SunPosition s = sun.position(noon);
+			MoonPosition m = moon.position(noon);
+			out[n].sunAzimuth = s.azimuth;
+			out[n].sunAltitude = s.altitude;
+			out[n].moonAzimuth = m.azimuth;
+			out[n].moonAltitude = m.altitude;
+		}
+	}
+	return n;
+}
+
+static Reference results[5 * 5300];
+static Reference reference[5 * 5300];
+
+int main(int argc, char ** argv) {
+#ifdef SUN_SINGLE_PRECISION
+	printf("Real is float\n");
+#else
+	printf("Real is double\n");
+#endif
+	kernels();
+
+	Sun sun(cities[0]);
+	Moon moon(cities[0]);
+	Date date(2026, 3, 1);
+	double start = benchSeconds();
+	for (int i = 0; i < 100000; i++)
+		sink = sun.sunset(date + DaySpan(i % 365)).unixtime();
+	double sunset = (benchSeconds() - start) * 1e4;
+	DateTime t(Date(2026, 3, 1), Time(12, 0, 0));
+	start = benchSeconds();
+	for (int i = 0; i < 100000; i++)
+		sink = moon.position(DateTime(t.unixtime() + i * 600)).altitude;
+	double position = (benchSeconds() - start) * 1e4;
+	printf("this build: Sun::sunset %.0f ns, Moon::position %.0f ns\n", sunset, position);
+
+	uint32_t n = grid(results);
+	if (argc == 3 && strcmp(argv[1], "-w") == 0) {
+		FILE * f = fopen(argv[2], "wb");
+		if (!f || fwrite(results, sizeof(Reference), n, f) != n)
+			return 1;
+		fclose(f);
+		printf("wrote %u reference samples\n", n);
+	} else if (argc == 2) {
+		FILE * f = fopen(argv[1], "rb");
+		if (!f || fread(reference, sizeof(Reference), n, f) != n)
+			return 1;
+		fclose(f);
+		double times = 0, sunAngle = 0, moonAngle = 0;
+		for (uint32_t i = 0; i < n; i++) {
+			times = fmax(times, fabs((double)(results[i].sunrise - reference[i].sunrise)));
+			times = fmax(times, fabs((double)(results[i].sunset - reference[i].sunset)));
+			sunAngle = fmax(sunAngle, fabs(results[i].sunAzimuth - reference[i].sunAzimuth));
+			sunAngle = fmax(sunAngle, fabs(results[i].sunAltitude - reference[i].sunAltitude));
+			moonAngle = fmax(moonAngle, fabs(results[i].moonAzimuth - reference[i].moonAzimuth));
+			moonAngle = fmax(moonAngle, fabs(results[i].moonAltitude - reference[i].moonAltitude));
+		}
+		printf("against the reference, %u samples:\n", n);
+		printf("  sunrise/sunset           %.0f s\n", times);
+		printf("  sun azimuth/altitude     %.1e (units of pi)\n", sunAngle);
+		printf("  moon azimuth/altitude    %.1e (units of pi)\n", moonAngle);
+	}
+	return 0;
+}
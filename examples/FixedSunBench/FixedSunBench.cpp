@@ -0,0 +1,88 @@
+// fixedSunTimes against the floating point Sun::sunrise and Sun::sunset, and the cycles
+// per call of both. build on a host from the repository root, without SUN_FIXED_POINT
+// so Sun keeps the floating point path as the reference:
+//   g++ -O2 -I. examples/FixedSunBench/FixedSunBench.cpp FixedSun.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o fixedsun
+// exits with 1 when a difference up to 65 degrees, where Sun uses fixedSunTimes, is
+// larger than BOUND seconds.
+#include <stdio.h>
+#include <math.h>
+#include "FixedSun.h"
+#include "examples/Bench.h"
+
+#define DATES 1024
+#define ROUNDS 200
+#define BOUND 10
+
+volatile time_t sink;
+
+int main() {
+	const Real latitudes[] = { -55, -45, -33.9, -20, 0, 10, 31.78, 40.7, 51.5, 55.7, 60, 62, 64, 65, 66 };
+	double worst60 = 0, worst65 = 0, worst = 0, sum = 0;
+	uint32_t count = 0;
+	for (uint8_t l = 0; l < sizeof(latitudes) / sizeof(Real); l++) {
+		double latitudeWorst = 0;
+		for (Real longitude = -180; longitude < 180; longitude += (Real)37.3) {
+			ObserverLocation observer = { latitudes[l], longitude };
+			Sun sun(observer);
+			int32_t latitude = fixedAngle(observer.latitude), lon = fixedAngle(observer.longitude);
+			for (uint16_t year = 1901; year < 2100; year += 3)
+				for (uint8_t month = 1; month <= 12; month++)
+					for (uint8_t day = 1; day <= 28; day += 9) {
+						Date date(year, month, day);
+						time_t rise = sun.sunrise(date).unixtime(), set = sun.sunset(date).unixtime();
+						// skip polar day and night, where the floating point times are not defined
+						if (rise < 0 || rise > 5000000000LL || set < rise || set - rise > 86400)
+							continue;
+						time_t fixedRise, fixedSet;
+						fixedSunTimes(date.daysSinceEpoch(), latitude, lon, &fixedRise, &fixedSet);
+						double e = fmax(fabs((double)(fixedRise - rise)), fabs((double)(fixedSet - set)));
+						latitudeWorst = fmax(latitudeWorst, e);
+						sum += e;
+						count++;
+					}
+		}
+		printf("latitude %6.2f: largest difference %.0f s\n", (double)latitudes[l], latitudeWorst);
+		if (fabs(latitudes[l]) <= 60)
+			worst60 = fmax(worst60, latitudeWorst);
+		if (fabs(latitudes[l]) <= 65)
+			worst65 = fmax(worst65, latitudeWorst);
+		worst = fmax(worst, latitudeWorst);
+	}
+	printf("%u days: largest difference %.0f s up to 60 degrees, %.0f s up to 65, %.0f s overall, mean %.2f s\n",
+			count, worst60, worst65, worst, sum / count);
+	if (worst65 > BOUND) {
+		printf("more than %d s up to 65 degrees\n", BOUND);
+		return 1;
+	}
+
+	ObserverLocation jerusalem = { 31.778, 35.235 };
+	Sun sun(jerusalem);
+	int32_t latitude = fixedAngle(jerusalem.latitude), longitude = fixedAngle(jerusalem.longitude);
+	static Date dates[DATES];
+	static int32_t days[DATES];
+	for (uint16_t i = 0; i < DATES; i++) {
+		dates[i] = Date(2024, 1 + i % 12, 1 + i % 28);
+		days[i] = dates[i].daysSinceEpoch();
+	}
+#ifdef BENCH_CYCLES
+	uint64_t best[2] = { ~0ull, ~0ull };
+	for (uint8_t r = 0; r < 5; r++) {
+		uint64_t start = benchCycles();
+		for (uint32_t i = 0; i < ROUNDS * DATES; i++) {
+			time_t rise, set;
+			fixedSunTimes(days[i % DATES], latitude, longitude, &rise, &set);
+			sink = rise + set;
+		}
+		uint64_t fixed = (benchCycles() - start) / (ROUNDS * DATES);
+		start = benchCycles();
+		for (uint32_t i = 0; i < ROUNDS * DATES; i++)
+			sink = sun.sunrise(dates[i % DATES]).unixtime();
+		uint64_t floating = (benchCycles() - start) / (ROUNDS * DATES);
+		best[0] = fixed < best[0] ? fixed : best[0];
+		best[1] = floating < best[1] ? floating : best[1];
+	}
+	printf("cycles per call, best of 5: fixedSunTimes %llu (both times), Sun::sunrise %llu\n",
+			(unsigned long long)best[0], (unsigned long long)best[1]);
+#endif
+	return 0;
+}
@@ -0,0 +1,72 @@
+// HebrewClock against HebrewDay::at(), and the cost of a tick. build on a host from the
+// repository root:
+//   g++ -O2 -I. examples/HebrewClockBench/HebrewClockBench.cpp HebrewDateTime.cpp HebrewDate.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o hebrewclock
+// cycle counts need an x86 host; they include the overhead of rdtsc itself.
+#include <stdio.h>
+#include <stdlib.h>
+#include "HebrewDateTime.h"
+#include "examples/Bench.h"
+
+#define DAYS 100
+
+static int compare(const void * a, const void * b) {
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+	return x < y ? -1 : x > y;
+}
+
+int main() {
+	ObserverLocation jerusalem = { 31.778, 35.235 };
+	time_t first = DateTime(Date(2026, 1, 1), Time(7, 30, 0)).unixtime();
+
+	// every second of 200 days, checked every 97 s
+	HebrewClock clock(jerusalem);
+	HebrewDay day(jerusalem);
+	clock.start(DateTime(first));
+	uint32_t mismatches = 0, checks = 0, worst = 0;
+	for (uint32_t s = 1; s <= 200 * 86400u; s++) {
+		clock.tick();
+		if (s % 97)
+			continue;
+		HebrewDateTime expected = day.at(DateTime(first + s));
+		int32_t chalakim = (int32_t)(expected.parts() * 1080);
+		int32_t difference = abs(chalakim - clock.chalakim());
+		if (difference > 540)
+			difference = 1080 - difference;
+		if (expected.hour() != clock.hour() || expected.date().key() != clock.date().key())
+			mismatches++;
+		else if ((uint32_t)difference > worst)
+			worst = difference;
+		checks++;
+	}
+	printf("%u checks over 200 days: %u hour or date mismatches, chalakim within %u\n", checks, mismatches, worst);
+
+#ifdef BENCH_CYCLES
+	// one timed tick per simulated second
+	static uint32_t ticks[DAYS * 86400];
+	static uint32_t crossings[4 * DAYS];
+	uint32_t t = 0, c = 0;
+	clock.start(DateTime(first));
+	for (uint32_t s = 0; s < DAYS * 86400u; s++) {
+		bool boundary = clock.secondsToBoundary() <= 1;
+		uint64_t start = benchCycles();
+		clock.tick();
+		uint32_t cycles = benchCycles() - start;
+		if (boundary && c < 4 * DAYS)
+			crossings[c++] = cycles;
+		else
+			ticks[t++] = cycles;
+	}
+	qsort(ticks, t, sizeof(uint32_t), compare);
+	qsort(crossings, c, sizeof(uint32_t), compare);
+	printf("tick: median %u cycles, 99.99th percentile %u, worst %u\n", ticks[t / 2],
+			ticks[(uint32_t)(t * 0.9999)], ticks[t - 1]);
+	printf("boundary crossing (%u): median %u cycles, worst %u\n", c, crossings[c / 2], crossings[c - 1]);
+
+	clock.start(DateTime(first));
+	uint64_t start = benchCycles();
+	for (uint32_t s = 0; s < DAYS * 86400u; s++)
+		clock.tick();
+	printf("tight loop: %.1f cycles per tick\n", (double)(benchCycles() - start) / (DAYS * 86400.0));
+#endif
+	return 0;
+}
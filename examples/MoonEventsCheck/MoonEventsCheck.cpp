@@ -0,0 +1,86 @@
+// Moon::events against a brute force scan of altitudeAt() every 60 s, for every day of
+// 2026 at five latitudes up to 65 degrees, and the time of events(). build on a host
+// from the repository root:
+//   g++ -O2 -I. examples/MoonEventsCheck/MoonEventsCheck.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o moonevents
+// the time is also given in altitudeAt() calls. exits with 1 when a rise or set is
+// missed or invented, or more than 90 s off.
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Sun.h"
+#include "examples/Bench.h"
+
+#define SCAN 60
+#define DAYS 365
+
+volatile Real sink;
+
+// first rise and set of the scan within 24 hours of t, each placed in the middle of the
+// minute in which the altitude crosses the horizon
+static MoonEvents scan(Moon * moon, time_t t) {
+	Real hc = (Real)(0.133 * M_PI / 180);
+	MoonEvents e;
+	e.rise = e.set = DateTime(t);
+	e.rises = e.sets = false;
+	Real h0 = moon->altitudeAt(t) - hc;
+	for (uint32_t s = SCAN; s <= 86400; s += SCAN) {
+		Real h1 = moon->altitudeAt(t + s) - hc;
+		if (h0 < 0 && h1 >= 0 && !e.rises) {
+			e.rise = DateTime(t + s - SCAN / 2);
+			e.rises = true;
+		} else if (h0 >= 0 && h1 < 0 && !e.sets) {
+			e.set = DateTime(t + s - SCAN / 2);
+			e.sets = true;
+		}
+		h0 = h1;
+	}
+	return e;
+}
+
+static bool agree(bool found, DateTime time, bool expected, DateTime reference, long * worst) {
+	if (found != expected)
+		return false;
+	long e = found ? labs((long)(time.unixtime() - reference.unixtime())) : 0;
+	if (e > *worst)
+		*worst = e;
+	return e <= 90;
+}
+
+int main() {
+	const ObserverLocation locations[] = { { 31.778, 35.235 }, { -33.9, 18.4 }, { 51.5, -0.12 },
+			{ 60, 10.75 }, { 65, 25.47 } };
+	time_t first = DateTime(Date(2026, 1, 1), Time(0, 0, 0)).unixtime();
+	uint32_t failures = 0;
+	for (uint8_t l = 0; l < 5; l++) {
+		Moon moon(locations[l]);
+		uint32_t days = 0;
+		long worst = 0;
+		for (uint16_t d = 0; d < DAYS; d++) {
+			time_t t = first + (time_t)d * 86400;
+			MoonEvents e = moon.events(DateTime(t)), r = scan(&moon, t);
+			bool ok = agree(e.rises, e.rise, r.rises, r.rise, &worst) && agree(e.sets, e.set, r.sets, r.set, &worst);
+			if (!ok) {
+				days++;
+				if (days <= 3)
+					printf("  %lld: rise %d %lld, set %d %lld; scan rise %d %lld, set %d %lld\n", (long long)t,
+							e.rises, (long long)e.rise.unixtime(), e.sets, (long long)e.set.unixtime(), r.rises,
+							(long long)r.rise.unixtime(), r.sets, (long long)r.set.unixtime());
+			}
+		}
+		printf("latitude %6.2f: %u of %u days disagree with the scan, largest difference %ld s\n",
+				(double)locations[l].latitude, days, DAYS, worst);
+		failures += days;
+	}
+
+	Moon moon(locations[0]);
+	double start = benchSeconds();
+	for (uint16_t d = 0; d < DAYS; d++)
+		sink = moon.events(DateTime(first + (time_t)d * 86400)).rises;
+	double events = (benchSeconds() - start) / DAYS;
+	start = benchSeconds();
+	for (uint32_t i = 0; i < 100000; i++)
+		sink = moon.altitudeAt(first + (time_t)i * 313);
+	double altitude = (benchSeconds() - start) / 100000;
+	printf("events(): %.0f ns per day, the time of %.1f altitudeAt() calls\n", events * 1e9, events / altitude);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,101 @@
+// error of the float build (SUN_SINGLE_PRECISION) against the double one, every 7 days
+// of 2000-2100 in five cities, and the time of sunset() and Moon::position() in each
+// build. the double build writes the reference, the float build compares:
+//   g++ -O2 -I. examples/PrecisionCheck/PrecisionCheck.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o double
+//   g++ -O2 -I. -DSUN_SINGLE_PRECISION examples/PrecisionCheck/PrecisionCheck.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o float
+//   ./double -w reference.bin && ./float reference.bin
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "Sun.h"
+#include "examples/Bench.h"
+
+typedef struct {
+	time_t sunrise;
+	time_t sunset;
+	double sunAzimuth;
+	double sunAltitude;
+	double moonAzimuth;
+	double moonAltitude;
+	double moonFraction;
+} Sample;
+
+#define SAMPLES (5 * 5300)
+
+static const ObserverLocation cities[] = { { 31.778, 35.235 }, { 40.71, -74.01 }, { 51.5, -0.12 },
+		{ -33.9, 151.2 }, { 55.75, 37.62 } };
+
+static Sample results[SAMPLES];
+static Sample reference[SAMPLES];
+volatile double sink;
+
+static uint32_t grid(Sample * out) {
+	uint32_t n = 0;
+	time_t first = DateTime(Date(2000, 1, 1), Time(0, 0, 0)).unixtime();
+	time_t last = DateTime(Date(2100, 1, 1), Time(0, 0, 0)).unixtime();
+	for (uint8_t c = 0; c < 5; c++) {
+		Sun sun(cities[c]);
+		Moon moon(cities[c]);
+		for (time_t t = first; t < last; t += 7 * 86400, n++) {
+			Date date = DateTime(t).date();
+			DateTime evening(t + 19 * 3600);
+			out[n].sunrise = sun.sunrise(date).unixtime();
+			out[n].sunset = sun.sunset(date).unixtime();
+			SunPosition s = sun.position(evening);
+			MoonPosition m = moon.position(evening);
+			out[n].sunAzimuth = s.azimuth;
+			out[n].sunAltitude = s.altitude;
+			out[n].moonAzimuth = m.azimuth;
+			out[n].moonAltitude = m.altitude;
+			out[n].moonFraction = moon.illumination(evening).fraction;
+		}
+	}
+	return n;
+}
+
+int main(int argc, char ** argv) {
+	Sun sun(cities[0]);
+	Moon moon(cities[0]);
+	Date date(2026, 3, 1);
+	double start = benchSeconds();
+	for (int i = 0; i < 100000; i++)
+		sink = sun.sunset(date + DaySpan(i % 365)).unixtime();
+	double sunset = (benchSeconds() - start) * 1e4;
+	time_t t = DateTime(date, Time(12, 0, 0)).unixtime();
+	start = benchSeconds();
+	for (int i = 0; i < 100000; i++)
+		sink = moon.position(DateTime(t + i * 600)).altitude;
+	double position = (benchSeconds() - start) * 1e4;
+	printf("Real is %s: sunset() %.0f ns, Moon::position() %.0f ns\n", sizeof(Real) == 4 ? "float" : "double",
+			sunset, position);
+
+	uint32_t n = grid(results);
+	if (argc == 3 && strcmp(argv[1], "-w") == 0) {
+		FILE * f = fopen(argv[2], "wb");
+		if (!f || fwrite(results, sizeof(Sample), n, f) != n)
+			return 1;
+		fclose(f);
+		printf("wrote %u reference samples\n", n);
+	} else if (argc == 2) {
+		FILE * f = fopen(argv[1], "rb");
+		if (!f || fread(reference, sizeof(Sample), n, f) != n)
+			return 1;
+		fclose(f);
+		double times = 0, sunAngle = 0, moonAngle = 0, fraction = 0;
+		for (uint32_t i = 0; i < n; i++) {
+			times = fmax(times, fabs((double)(results[i].sunrise - reference[i].sunrise)));
+			times = fmax(times, fabs((double)(results[i].sunset - reference[i].sunset)));
+			sunAngle = fmax(sunAngle, fabs(results[i].sunAzimuth - reference[i].sunAzimuth));
+			sunAngle = fmax(sunAngle, fabs(results[i].sunAltitude - reference[i].sunAltitude));
+			moonAngle = fmax(moonAngle, fabs(results[i].moonAzimuth - reference[i].moonAzimuth));
+			moonAngle = fmax(moonAngle, fabs(results[i].moonAltitude - reference[i].moonAltitude));
+			fraction = fmax(fraction, fabs(results[i].moonFraction - reference[i].moonFraction));
+		}
+		printf("against the reference, %u samples:\n", n);
+		printf("  sunrise/sunset            %.0f s\n", times);
+		printf("  sun azimuth/altitude      %.1e (units of pi)\n", sunAngle);
+		printf("  moon azimuth/altitude     %.1e (units of pi)\n", moonAngle);
+		printf("  moon illuminated fraction %.1e\n", fraction);
+	}
+	return 0;
+}
@@ -0,0 +1,48 @@
+// Sun::times for a range of days against paired sunrise()/sunset() calls: the largest
+// difference and days per millisecond. build on a host from the repository root:
+//   g++ -O2 -I. examples/SunTimesBench/SunTimesBench.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o suntimes
+#include <stdio.h>
+#include <stdlib.h>
+#include "Sun.h"
+#include "examples/Bench.h"
+
+#define DAYS 365
+#define ROUNDS 200
+
+static time_t sunrises[DAYS];
+static time_t sunsets[DAYS];
+volatile time_t sink;
+
+int main() {
+	ObserverLocation jerusalem = { 31.778, 35.235 };
+	Sun sun(jerusalem);
+	Date first(2026, 1, 1);
+
+	sun.times(first, DAYS, sunrises, sunsets);
+	long worst = 0;
+	for (uint16_t i = 0; i < DAYS; i++) {
+		Date date = first + DaySpan(i);
+		long rise = labs((long)(sunrises[i] - sun.sunrise(date).unixtime()));
+		long set = labs((long)(sunsets[i] - sun.sunset(date).unixtime()));
+		if (rise > worst)
+			worst = rise;
+		if (set > worst)
+			worst = set;
+	}
+	printf("2026 at Jerusalem: largest difference from sunrise()/sunset() %ld s\n", worst);
+
+	double start = benchSeconds();
+	for (uint16_t r = 0; r < ROUNDS; r++)
+		sun.times(first, DAYS, sunrises, sunsets);
+	double batch = (benchSeconds() - start) * 1e3;
+	start = benchSeconds();
+	for (uint16_t r = 0; r < ROUNDS / 10; r++)
+		for (uint16_t i = 0; i < DAYS; i++) {
+			Date date = first + DaySpan(i);
+			sink = sun.sunrise(date).unixtime() + sun.sunset(date).unixtime();
+		}
+	double scalar = (benchSeconds() - start) * 1e3;
+	printf("Sun::times %.0f days/ms, sunrise()+sunset() %.0f days/ms\n", DAYS * ROUNDS / batch,
+			DAYS * (ROUNDS / 10) / scalar);
+	return 0;
+}
@@ -0,0 +1,59 @@
+// accuracy and speed of Sun::track against position() per sample,
+// over three days at 10 s steps. build on a host from the repository root:
+//   g++ -O2 -I. examples/TrackCheck/TrackCheck.cpp Sun.cpp Crossing.cpp Ephemeris.cpp Date.cpp DateTime.cpp Time.cpp -o trackcheck
+#include <stdio.h>
+#include <math.h>
+#include "Sun.h"
+#include "examples/Bench.h"
+
+#define STEP 10
+#define COUNT (3 * 86400 / STEP)
+
+static Real azimuths[COUNT];
+static Real altitudes[COUNT];
+
+int main() {
+	const ObserverLocation locations[] = { { 31.778, 35.235 }, { 51.5, -0.12 }, { -33.9, 151.2 }, { 64.1, -21.9 } };
+	DateTime starts[] = { DateTime(Date(2024, 3, 19), Time(0, 0, 0)), DateTime(Date(2024, 6, 20), Time(5, 0, 0)),
+			DateTime(Date(2025, 12, 20), Time(17, 30, 0)) };
+	double worst = 0, worstAzimuth = 0, worstSky = 0;
+	for (uint8_t l = 0; l < 4; l++) {
+		Sun sun(locations[l]);
+		for (uint8_t s = 0; s < 3; s++) {
+			SunTrack out = { azimuths, altitudes };
+			sun.track(starts[s], STEP, COUNT, out);
+			time_t t0 = starts[s].unixtime();
+			for (uint32_t i = 0; i < COUNT; i++) {
+				SunPosition p = sun.position(DateTime(t0 + (time_t)i * STEP));
+				double e = fabs(altitudes[i] - p.altitude) * 180 * 3600;
+				if (e > worst)
+					worst = e;
+				// azimuths are in units of pi and wrap at two. near the zenith and the nadir
+				// a small error on the sky is a large one in azimuth, so both are reported.
+				double a = fabs(azimuths[i] - p.azimuth);
+				e = (a > 1 ? 2 - a : a) * 180 * 3600;
+				if (e > worstAzimuth)
+					worstAzimuth = e;
+				e *= cos(p.altitude * M_PI);
+				if (e > worstSky)
+					worstSky = e;
+			}
+		}
+	}
+	printf("largest difference from position(): altitude %.2f arcsec, azimuth %.2f arcsec (%.2f on the sky)\n",
+			worst, worstAzimuth, worstSky);
+
+	Sun sun(locations[0]);
+	SunTrack out = { azimuths, altitudes };
+	double t = benchSeconds();
+	for (uint8_t r = 0; r < 10; r++)
+		sun.track(starts[0], STEP, COUNT, out);
+	double trackTime = (benchSeconds() - t) / (10.0 * COUNT);
+	volatile Real sink = 0;
+	t = benchSeconds();
+	for (uint32_t i = 0; i < COUNT; i++)
+		sink = sink + sun.position(DateTime(starts[0].unixtime() + (time_t)i * STEP)).altitude;
+	double positionTime = (benchSeconds() - t) / COUNT;
+	printf("track: %.0f ns per sample, position(): %.0f ns per sample\n", trackTime * 1e9, positionTime * 1e9);
+	return 0;
+}
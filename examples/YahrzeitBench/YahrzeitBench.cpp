@@ -0,0 +1,105 @@
+// HebrewDate::yahrzeits() and birthdays() against the per-record rules of Reingold and
+// Dershowitz, and the time of a batch of 4 million records. build on a host from the
+// repository root, without and with OpenMP:
+//   g++ -O2 -I. examples/YahrzeitBench/YahrzeitBench.cpp HebrewDate.cpp Date.cpp DateTime.cpp Time.cpp -o yahrzeit
+//   g++ -O2 -fopenmp -I. examples/YahrzeitBench/YahrzeitBench.cpp HebrewDate.cpp Date.cpp DateTime.cpp Time.cpp -o yahrzeit
+// the OpenMP build times the batch on one thread and on all of them. exits with 1 on a
+// mismatch.
+#include <stdio.h>
+#include <stdlib.h>
+#include "HebrewDate.h"
+#include "examples/Bench.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define RECORDS 4000000
+#define CHECKED 200000
+
+static HebrewDate dates[RECORDS];
+static int32_t days[RECORDS];
+
+static uint32_t seed = 12345;
+
+static uint32_t next() {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static int32_t fixed(uint16_t year, uint8_t month, uint8_t day) {
+	return HebrewDate(year, month, 1).daysSinceEpoch() + day - 1;
+}
+
+// Calendrical Calculations, hebrew-yahrzeit
+static int32_t yahrzeit(HebrewDate death, uint16_t year) {
+	if (death.month() == 8 && death.day() == 30 && !HebrewDate::isLongHeshvanYear(death.year() + 1))
+		return fixed(year, 9, 1) - 1;
+	if (death.month() == 9 && death.day() == 30 && HebrewDate::isShortKislevYear(death.year() + 1))
+		return fixed(year, 10, 1) - 1;
+	if (death.month() == 13)
+		return fixed(year, HebrewDate::numMonthsInYear(year), death.day());
+	if (death.month() == 12 && death.day() == 30 && !HebrewDate::isLeapYear(year))
+		return fixed(year, 11, 30);
+	return fixed(year, death.month(), death.day());
+}
+
+// Calendrical Calculations, hebrew-birthday
+static int32_t birthday(HebrewDate birth, uint16_t year) {
+	if (birth.month() == HebrewDate::numMonthsInYear(birth.year()))
+		return fixed(year, HebrewDate::numMonthsInYear(year), birth.day());
+	return fixed(year, birth.month(), birth.day());
+}
+
+static double timed(bool anniversaries, uint16_t year) {
+	double start = benchSeconds();
+	if (anniversaries)
+		HebrewDate::yahrzeits(dates, RECORDS, year, days);
+	else
+		HebrewDate::birthdays(dates, RECORDS, year, days);
+	return benchSeconds() - start;
+}
+
+static uint32_t check(bool anniversaries, uint16_t year) {
+	uint32_t mismatches = 0;
+	for (uint32_t i = 0; i < RECORDS; i += RECORDS / CHECKED) {
+		int32_t expected = anniversaries ? yahrzeit(dates[i], year) : birthday(dates[i], year);
+		if (days[i] != expected && mismatches++ < 5)
+			printf("  %u-%u-%u in %u: %d, expected %d\n", dates[i].year(), dates[i].month(),
+					dates[i].day(), year, days[i], expected);
+	}
+	return mismatches;
+}
+
+int main() {
+	// every date of 5600-5780 is equally likely, including 30 Cheshvan, 30 Kislev,
+	// 30 Adar I and Adar II
+	for (uint32_t i = 0; i < RECORDS; i++) {
+		uint16_t year = 5600 + next() % 181;
+		uint8_t month = 1 + next() % HebrewDate::numMonthsInYear(year);
+		uint8_t day = 1 + next() % HebrewDate::numDaysInMonth(year, month);
+		dates[i] = HebrewDate(year, month, day);
+	}
+
+	// a common and a leap year with a short Kislev, a common and a leap year with a long
+	// Cheshvan
+	static const uint16_t years[] = { 5781, 5784, 5785, 5787 };
+	uint32_t mismatches = 0;
+	for (uint8_t a = 0; a < 2; a++) {
+		for (uint8_t y = 0; y < 4; y++) {
+			timed(a, years[y]);
+			mismatches += check(a, years[y]);
+		}
+		double elapsed = timed(a, years[0]);
+		printf("%s: %u records in %.1f ms", a ? "yahrzeits" : "birthdays", RECORDS, elapsed * 1e3);
+#ifdef _OPENMP
+		int threads = omp_get_max_threads();
+		omp_set_num_threads(1);
+		double serial = timed(a, years[0]);
+		omp_set_num_threads(threads);
+		printf(" on %d threads, %.1f ms on one (%.1fx)", threads, serial * 1e3, serial / elapsed);
+#endif
+		printf("\n");
+	}
+	printf("%u mismatches in %u checked records\n", mismatches, 8 * CHECKED);
+	return mismatches ? 1 : 0;
+}